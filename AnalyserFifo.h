@@ -0,0 +1,84 @@
+#pragma once
+#include <JuceHeader.h>
+#include <algorithm>
+#include <memory>
+#include <type_traits>
+
+// Wait-free single-producer/single-consumer ring of mono samples, feeding the editor's analyser.
+// The audio thread pushes, the editor's timer pulls; if the editor falls behind, new audio is dropped.
+// The ring is allocated by the first allocate(), which has to happen before anything is pushed.
+class AnalyserFifo
+{
+public:
+    static constexpr int capacity = 1 << 15;
+
+    // Message thread; does nothing once allocated
+    void allocate()
+    {
+        if (buffer == nullptr)
+            buffer = std::make_unique<float[]>(static_cast<size_t>(capacity));
+    }
+
+    // Pushes the average of all channels; double blocks are narrowed on the way in
+    template <typename SampleType>
+    void push(const SampleType* const* channels, size_t numChannels, size_t numSamples) noexcept
+    {
+        if (numChannels == 0)
+            return;
+
+        int start1, size1, start2, size2;
+        fifo.prepareToWrite(static_cast<int>(numSamples), start1, size1, start2, size2);
+
+        const auto gain = 1.0f / static_cast<float>(numChannels);
+        writeMono(channels, numChannels, 0, start1, size1, gain);
+        writeMono(channels, numChannels, static_cast<size_t>(size1), start2, size2, gain);
+
+        fifo.finishedWrite(size1 + size2);
+    }
+
+    int pull(float* dest, int maxSamples) noexcept
+    {
+        int start1, size1, start2, size2;
+        fifo.prepareToRead(maxSamples, start1, size1, start2, size2);
+
+        if (size1 + size2 == 0)
+            return 0;
+
+        std::copy_n(buffer.get() + start1, size1, dest);
+        std::copy_n(buffer.get() + start2, size2, dest + size1);
+
+        fifo.finishedRead(size1 + size2);
+        return size1 + size2;
+    }
+
+    void reset() noexcept { fifo.reset(); }
+
+private:
+    template <typename SampleType>
+    void writeMono(const SampleType* const* channels, size_t numChannels, size_t sourceOffset, int destStart, int num, float gain) noexcept
+    {
+        auto* dest = buffer.get() + destStart;
+
+        if constexpr (std::is_same_v<SampleType, float>)
+        {
+            juce::FloatVectorOperations::copyWithMultiply(dest, channels[0] + sourceOffset, gain, num);
+
+            for (size_t ch = 1; ch < numChannels; ++ch)
+                juce::FloatVectorOperations::addWithMultiply(dest, channels[ch] + sourceOffset, gain, num);
+        }
+        else
+        {
+            for (int i = 0; i < num; ++i)
+            {
+                SampleType sum = 0;
+                for (size_t ch = 0; ch < numChannels; ++ch)
+                    sum += channels[ch][sourceOffset + static_cast<size_t>(i)];
+
+                dest[i] = static_cast<float>(sum) * gain;
+            }
+        }
+    }
+
+    juce::AbstractFifo fifo{ capacity };
+    std::unique_ptr<float[]> buffer;
+};
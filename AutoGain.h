@@ -0,0 +1,313 @@
+#pragma once
+#include <JuceHeader.h>
+#include <array>
+#include <atomic>
+#include <cmath>
+#include <vector>
+#include "BiquadTopologies.h"
+
+// Keeps the output as loud as the input, so A/B comparisons aren't won by the louder side. Input and output
+// are measured with the BS.1770 short-term loudness (K-weighting, 3 s window), and the difference becomes one
+// output gain, smoothed over about a second and ramped across each block.
+//
+// The input and output channels are packed side by side into the lanes of the same registers, so a stereo
+// instance meters all four signals in one pass of two sections. The meter runs at the full rate: the EQ's
+// high band reaches 12.5 kHz, and a meter below it would weight (or high-pass away) a shelf's boost at its alias.
+class AutoGain
+{
+public:
+    using Vec = juce::dsp::SIMDRegister<float>;
+    static constexpr size_t maxChannels = 16;
+    static constexpr size_t maxGroups = (2 * maxChannels + Vec::SIMDNumElements - 1) / Vec::SIMDNumElements;
+
+    static constexpr float gateLufs = -70.0f; // BS.1770's absolute gate; below it there's nothing to match
+    static constexpr float maxGainDb = 24.0f;
+
+    // Allocates. Weights are per channel, as BS.1770 gives them (1.41 for the side surrounds, 0 for the LFE).
+    void prepare(double sampleRate, int maximumBlockSize, const std::vector<float>& channelWeights)
+    {
+        numChannels = juce::jmin(channelWeights.size(), maxChannels);
+        numGroups = (2 * numChannels + Vec::SIMDNumElements - 1) / Vec::SIMDNumElements;
+        frameStride = numGroups * Vec::SIMDNumElements;
+        sliceFrames = static_cast<size_t>(juce::jmax(1, juce::roundToInt(0.1 * sampleRate)));
+
+        // Lanes past the channels stay zero; the extra register's worth leaves room to align the start
+        maxFrames = static_cast<size_t>(juce::jmax(1, maximumBlockSize));
+        frameStorage.assign(maxFrames * frameStride + Vec::SIMDNumElements, 0.0f);
+        frames = Vec::getNextSIMDAlignedPtr(frameStorage.data());
+
+        shelf.setAll(makeHeadShelf(sampleRate));
+        highPass.setAll(makeHighPass(sampleRate));
+
+        weights.fill(0.0f);
+        for (size_t ch = 0; ch < numChannels; ++ch)
+            weights[ch] = weights[numChannels + ch] = channelWeights[ch];
+
+        samplePeriod = 1.0 / sampleRate;
+        reset();
+    }
+
+    void reset() noexcept
+    {
+        resetMeter();
+        currentGainDb = targetGainDb = 0.0f;
+        currentGain = 1.0f;
+        hasInput = false;
+        publish();
+    }
+
+    // Audio thread. Switching on starts a fresh measurement; switching off glides back to unity.
+    void setEnabled(bool shouldBeEnabled) noexcept
+    {
+        if (shouldBeEnabled && !enabled)
+            resetMeter();
+
+        enabled = shouldBeEnabled;
+    }
+
+    bool isActive() const noexcept { return enabled || currentGain != 1.0f; }
+
+    // Before the block is processed: keeps the input samples the meter will look at
+    template <typename SampleType>
+    void pushInput(const SampleType* const* channels, size_t channelCount, size_t numSamples) noexcept
+    {
+        hasInput = enabled;
+        if (enabled)
+            gather(channels, juce::jmin(channelCount, numChannels), numSamples, 0);
+    }
+
+    // After the block is processed: meters the output against the pushed input, updates the gain and applies
+    // it. A block without pushed input (the chain was idle) counts as silence, which holds the gain.
+    template <typename SampleType>
+    void process(SampleType* const* channels, size_t channelCount, size_t numSamples) noexcept
+    {
+        if (!isActive())
+            return;
+
+        channelCount = juce::jmin(channelCount, numChannels);
+
+        if (enabled)
+        {
+            meter(channels, channelCount, numSamples);
+            updateTarget();
+        }
+        else
+        {
+            targetGainDb = 0.0f;
+        }
+
+        hasInput = false;
+
+        // One-pole in dB, a second to 1 - 1/e; snaps once it's inaudibly close
+        const auto coefficient = 1.0f - static_cast<float>(std::exp(-static_cast<double>(numSamples) * samplePeriod / smoothingSeconds));
+        currentGainDb += coefficient * (targetGainDb - currentGainDb);
+        if (std::abs(targetGainDb - currentGainDb) < 0.001f)
+            currentGainDb = targetGainDb;
+
+        const auto startGain = currentGain;
+        currentGain = currentGainDb == 0.0f ? 1.0f : juce::Decibels::decibelsToGain(currentGainDb);
+        applyRamp(channels, channelCount, numSamples, startGain, currentGain);
+
+        publish();
+    }
+
+    // Lock-free reads for the editor
+    float getInputLoudness() const noexcept { return inputLoudness.load(std::memory_order_relaxed); }
+    float getOutputLoudness() const noexcept { return outputLoudness.load(std::memory_order_relaxed); }
+    float getGainDb() const noexcept { return gainDb.load(std::memory_order_relaxed); }
+
+private:
+    static constexpr size_t numSlices = 30; // 100 ms each: the 3 s short-term window
+    static constexpr double smoothingSeconds = 1.0;
+
+    // BS.1770's two stages from their analogue prototypes, so they come out the same at any sample rate; at 48 kHz
+    // these are the standard's own coefficients. Stage 1 models the head, stage 2 is the RLB high-pass.
+    static BiquadCoefficients makeHeadShelf(double sampleRate) noexcept
+    {
+        constexpr double frequency = 1681.974450955533, Q = 0.7071752369554196, gainDb = 3.999843853973347;
+        const auto K = std::tan(juce::MathConstants<double>::pi * frequency / sampleRate);
+        const auto Vh = std::pow(10.0, gainDb / 20.0);
+        const auto Vb = std::pow(Vh, 0.4996667741545416);
+
+        return BiquadDesign::normalise(Vh + Vb * K / Q + K * K, 2.0 * (K * K - Vh), Vh - Vb * K / Q + K * K,
+            1.0 + K / Q + K * K, 2.0 * (K * K - 1.0), 1.0 - K / Q + K * K);
+    }
+
+    static BiquadCoefficients makeHighPass(double sampleRate) noexcept
+    {
+        constexpr double frequency = 38.13547087602444, Q = 0.5003270373238773;
+        const auto K = std::tan(juce::MathConstants<double>::pi * frequency / sampleRate);
+        const auto a0 = 1.0 + K / Q + K * K;
+
+        // The standard leaves the numerator unnormalised, 1 -2 1
+        return { 1.0, -2.0, 1.0, 2.0 * (K * K - 1.0) / a0, (1.0 - K / Q + K * K) / a0 };
+    }
+
+    void resetMeter() noexcept
+    {
+        for (auto* states : { &shelfS1, &shelfS2, &highPassS1, &highPassS2, &sums })
+            states->fill(Vec::expand(0.0f));
+
+        inputSlices.fill(0.0);
+        outputSlices.fill(0.0);
+        sliceFill = sliceIndex = numFullSlices = 0;
+        inputLoudnessValue = outputLoudnessValue = gateLufs;
+    }
+
+    // Copies the samples into their lanes: the input into the first numChannels, the output into the next.
+    // Returns the number of frames.
+    template <typename SampleType>
+    size_t gather(const SampleType* const* channels, size_t channelCount, size_t numSamples, size_t firstLane) noexcept
+    {
+        const auto numFrames = juce::jmin(numSamples, maxFrames);
+        for (size_t ch = 0; ch < channelCount; ++ch)
+            for (size_t k = 0; k < numFrames; ++k)
+                frames[k * frameStride + firstLane + ch] = static_cast<float>(channels[ch][k]);
+
+        return numFrames;
+    }
+
+    template <typename SampleType>
+    void meter(const SampleType* const* channels, size_t channelCount, size_t numSamples) noexcept
+    {
+        // Idle: the chain's output is below -120 dBFS, so the block counts as silence without running the filters
+        if (!hasInput)
+        {
+            for (auto remaining = numSamples; remaining > 0;)
+            {
+                const auto count = juce::jmin(remaining, sliceFrames - sliceFill);
+                sliceFill += count;
+                remaining -= count;
+
+                if (sliceFill == sliceFrames)
+                    closeSlice();
+            }
+
+            return;
+        }
+
+        const auto numFrames = gather(channels, channelCount, numSamples, numChannels);
+
+        // A group at a time through a slice's worth of frames, so its states stay in registers
+        for (size_t start = 0; start < numFrames;)
+        {
+            const auto end = juce::jmin(numFrames, start + sliceFrames - sliceFill);
+
+            for (size_t g = 0; g < numGroups; ++g)
+            {
+                auto shelf1 = shelfS1[g], shelf2 = shelfS2[g], highPass1 = highPassS1[g], highPass2 = highPassS2[g], sum = sums[g];
+                const auto* lanes = frames + g * Vec::SIMDNumElements;
+
+                for (auto k = start; k < end; ++k)
+                {
+                    auto x = Vec::fromRawArray(lanes + k * frameStride);
+                    x = TransposedDirectFormII<float>::tick(shelf, shelf1, shelf2, x);
+                    x = TransposedDirectFormII<float>::tick(highPass, highPass1, highPass2, x);
+                    sum += x * x;
+                }
+
+                shelfS1[g] = shelf1;
+                shelfS2[g] = shelf2;
+                highPassS1[g] = highPass1;
+                highPassS2[g] = highPass2;
+                sums[g] = sum;
+            }
+
+            sliceFill += end - start;
+            if (sliceFill == sliceFrames)
+                closeSlice();
+
+            start = end;
+        }
+    }
+
+    // Moves the slice's weighted mean squares into the ring, so the window is always the last numSlices slices
+    void closeSlice() noexcept
+    {
+        alignas(sizeof(Vec)) float lanes[maxGroups * Vec::SIMDNumElements] = {};
+        for (size_t g = 0; g < numGroups; ++g)
+            sums[g].copyToRawArray(lanes + g * Vec::SIMDNumElements);
+
+        double input = 0.0, output = 0.0;
+        for (size_t ch = 0; ch < numChannels; ++ch)
+        {
+            input += static_cast<double>(weights[ch] * lanes[ch]);
+            output += static_cast<double>(weights[numChannels + ch] * lanes[numChannels + ch]);
+        }
+
+        const auto scale = 1.0 / static_cast<double>(sliceFrames);
+        inputSlices[sliceIndex] = input * scale;
+        outputSlices[sliceIndex] = output * scale;
+        sliceIndex = (sliceIndex + 1) % numSlices;
+        numFullSlices = juce::jmin(numFullSlices + 1, numSlices);
+        sliceFill = 0;
+        sums.fill(Vec::expand(0.0f));
+    }
+
+    static float toLufs(double meanSquare) noexcept
+    {
+        return static_cast<float>(-0.691 + 10.0 * std::log10(juce::jmax(meanSquare, 1.0e-12)));
+    }
+
+    // Until the window has filled, the slices so far stand for it
+    void updateTarget() noexcept
+    {
+        if (numFullSlices == 0)
+            return;
+
+        double input = 0.0, output = 0.0;
+        for (size_t s = 0; s < numSlices; ++s)
+        {
+            input += inputSlices[s];
+            output += outputSlices[s];
+        }
+
+        const auto scale = 1.0 / static_cast<double>(numFullSlices);
+        inputLoudnessValue = toLufs(input * scale);
+        outputLoudnessValue = toLufs(output * scale);
+
+        // Silence on either side says nothing about the balance, so the last gain holds
+        if (inputLoudnessValue > gateLufs && outputLoudnessValue > gateLufs)
+            targetGainDb = juce::jlimit(-maxGainDb, maxGainDb, inputLoudnessValue - outputLoudnessValue);
+    }
+
+    template <typename SampleType>
+    static void applyRamp(SampleType* const* channels, size_t channelCount, size_t numSamples, float startGain, float endGain) noexcept
+    {
+        if (startGain == 1.0f && endGain == 1.0f)
+            return;
+
+        // From the sample index rather than accumulated, so the loop vectorises
+        const auto start = static_cast<SampleType>(startGain);
+        const auto step = (static_cast<SampleType>(endGain) - start) / static_cast<SampleType>(juce::jmax(numSamples, size_t(1)));
+
+        for (size_t ch = 0; ch < channelCount; ++ch)
+            for (size_t i = 0; i < numSamples; ++i)
+                channels[ch][i] *= start + step * static_cast<SampleType>(i + 1);
+    }
+
+    void publish() noexcept
+    {
+        inputLoudness.store(enabled ? inputLoudnessValue : gateLufs, std::memory_order_relaxed);
+        outputLoudness.store(enabled ? outputLoudnessValue : gateLufs, std::memory_order_relaxed);
+        gainDb.store(currentGainDb, std::memory_order_relaxed);
+    }
+
+    size_t numChannels = 0, numGroups = 0, frameStride = 0, sliceFrames = 1, maxFrames = 0;
+    std::vector<float> frameStorage;
+    float* frames = nullptr; // Aligned into frameStorage, frameStride lanes per frame
+    std::array<float, maxGroups * Vec::SIMDNumElements> weights{};
+
+    TransposedDirectFormII<float>::Coefficients shelf, highPass;
+    std::array<Vec, maxGroups> shelfS1, shelfS2, highPassS1, highPassS2, sums;
+
+    std::array<double, numSlices> inputSlices{}, outputSlices{};
+    size_t sliceFill = 0, sliceIndex = 0, numFullSlices = 0;
+    bool enabled = false, hasInput = false;
+
+    double samplePeriod = 1.0 / 44100.0;
+    float currentGainDb = 0.0f, targetGainDb = 0.0f, currentGain = 1.0f;
+    float inputLoudnessValue = gateLufs, outputLoudnessValue = gateLufs;
+
+    std::atomic<float> inputLoudness{ gateLufs }, outputLoudness{ gateLufs }, gainDb{ 0.0f };
+};
@@ -0,0 +1,109 @@
+#pragma once
+#include <JuceHeader.h>
+#include "MultichannelCascade.h"
+#include "CoefficientBank.h"
+
+// The cut stage of one muted band. It glides in from flat when the mute is engaged and back to flat when
+// it's released, and it's only processed while it's doing anything, so unmuted bands cost nothing.
+template <typename SampleType, template <typename> class Topology = TransposedDirectFormII, size_t maxChannels = 16>
+class BandCut
+{
+public:
+    void prepare(double sampleRate, size_t numChannels) noexcept
+    {
+        cascade.prepare(sampleRate, numChannels);
+        reset();
+    }
+
+    void reset() noexcept
+    {
+        cascade.reset();
+        for (size_t i = 0; i < CoefficientBank::numCutSections; ++i)
+            cascade.setCoefficients(i, BiquadCoefficients{});
+
+        active = false;
+        engagedChannels = 0;
+    }
+
+    void engage(const BiquadCoefficients& section) noexcept
+    {
+        activate();
+
+        for (size_t i = 0; i < CoefficientBank::numCutSections; ++i)
+            cascade.setTargetCoefficients(i, section);
+
+        engagedChannels = allChannels;
+    }
+
+    void release() noexcept
+    {
+        if (engagedChannels == 0)
+            return;
+
+        for (size_t i = 0; i < CoefficientBank::numCutSections; ++i)
+            cascade.setTargetCoefficients(i, BiquadCoefficients{});
+
+        engagedChannels = 0;
+    }
+
+    // Engages (section != nullptr) or releases the cut on one channel, for stereo modes with two band sets
+    // and for BatchEqEngine, where every channel has its own. immediately = true skips the glide.
+    void setChannel(size_t channel, const BiquadCoefficients* section, bool immediately = false) noexcept
+    {
+        const auto bit = juce::uint32(1) << channel;
+
+        if (section != nullptr)
+        {
+            activate();
+            setChannelSections(channel, *section, immediately);
+            engagedChannels |= bit;
+        }
+        else if ((engagedChannels & bit) != 0)
+        {
+            setChannelSections(channel, BiquadCoefficients{}, immediately);
+            engagedChannels &= ~bit;
+        }
+    }
+
+    void process(SampleType* const* channels, size_t numChannels, size_t numSamples) noexcept
+    {
+        if (!active)
+            return;
+
+        cascade.process(channels, numChannels, numSamples);
+
+        if (engagedChannels == 0 && !cascade.isRamping())
+            active = false;
+    }
+
+    void snapToTarget() noexcept { cascade.snapToTargets(); }
+
+    bool isActive() const noexcept { return active; }
+
+private:
+    static constexpr juce::uint32 allChannels = ~juce::uint32(0);
+
+    void activate() noexcept
+    {
+        if (active)
+            return;
+
+        cascade.reset(); // Every lane is flat with empty state, which is exactly where the last release left off
+        active = true;
+    }
+
+    void setChannelSections(size_t channel, const BiquadCoefficients& section, bool immediately) noexcept
+    {
+        for (size_t i = 0; i < CoefficientBank::numCutSections; ++i)
+        {
+            if (immediately)
+                cascade.setCoefficients(i, channel, section);
+            else
+                cascade.setTargetCoefficients(i, channel, section);
+        }
+    }
+
+    MultichannelCascade<SampleType, CoefficientBank::numCutSections, Topology, maxChannels> cascade;
+    bool active = false;
+    juce::uint32 engagedChannels = 0; // One bit per channel
+};
@@ -0,0 +1,74 @@
+#pragma once
+#include <JuceHeader.h>
+#include <cmath>
+#include "BiquadTopologies.h"
+#include "CoefficientBank.h"
+
+// Sidechain envelopes of the four bands for dynamic mode, one SIMD lane per band, so all four run in a single
+// pass. Each lane band-passes the mono sum of the input at its band's frequency and follows the peak level with
+// its own attack and release. Always runs in float; it only has to be accurate to a fraction of a dB.
+class BandDetector
+{
+public:
+    using Vec = juce::dsp::SIMDRegister<float>;
+    static_assert(Vec::SIMDNumElements >= CoefficientBank::numBands, "One lane per band");
+
+    void prepare(double newSampleRate) noexcept
+    {
+        sampleRate = newSampleRate;
+        filter.setAll(BiquadCoefficients{});
+        attack = release = Vec::expand(1.0f);
+        reset();
+    }
+
+    void reset() noexcept { s1 = s2 = envelope = Vec::expand(0.0f); }
+
+    void setBand(int band, double frequency, float attackMs, float releaseMs) noexcept
+    {
+        const auto lane = static_cast<size_t>(band);
+        filter.setLane(lane, BiquadDesign::makeBandPass(sampleRate, frequency, EqTables::fixedQ));
+        attack.set(lane, getCoefficient(attackMs));
+        release.set(lane, getCoefficient(releaseMs));
+    }
+
+    template <typename SampleType>
+    void process(const SampleType* const* channels, size_t numChannels, size_t start, size_t numSamples) noexcept
+    {
+        if (numChannels == 0)
+            return;
+
+        const auto gain = 1.0f / static_cast<float>(numChannels);
+        const auto zero = Vec::expand(0.0f);
+
+        for (size_t i = start; i < start + numSamples; ++i)
+        {
+            SampleType sum = 0;
+            for (size_t ch = 0; ch < numChannels; ++ch)
+                sum += channels[ch][i];
+
+            const auto y = TransposedDirectFormII<float>::tick(filter, s1, s2, Vec::expand(static_cast<float>(sum) * gain));
+            const auto level = Vec::max(y, zero - y);
+
+            // Branch-free peak follower: the first step can only rise (attack), the second only fall (release)
+            envelope += attack * (Vec::max(level, envelope) - envelope);
+            envelope += release * (Vec::min(level, envelope) - envelope);
+        }
+    }
+
+    float getLevelDb(int band) const noexcept
+    {
+        return juce::Decibels::gainToDecibels(envelope.get(static_cast<size_t>(band)));
+    }
+
+private:
+    // One-pole coefficient that covers 1 - 1/e of the distance in the given time
+    float getCoefficient(float milliseconds) const noexcept
+    {
+        const auto samples = juce::jmax(1.0, 0.001 * static_cast<double>(milliseconds) * sampleRate);
+        return static_cast<float>(1.0 - std::exp(-1.0 / samples));
+    }
+
+    double sampleRate = 44100.0;
+    TransposedDirectFormII<float>::Coefficients filter;
+    Vec s1, s2, envelope, attack, release;
+};
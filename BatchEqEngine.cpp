@@ -0,0 +1,68 @@
+#include "BatchEqEngine.h"
+
+void BatchEqEngine::prepare(double sampleRate, int newNumChannels)
+{
+    bank.prepare(sampleRate);
+
+    numChannels = juce::jmax(0, newNumChannels);
+    groups.resize(static_cast<size_t>((numChannels + lanesPerGroup - 1) / lanesPerGroup));
+
+    for (auto& group : groups)
+    {
+        group.cascade.prepare(sampleRate);
+        group.cascade.reset();
+
+        for (auto& cut : group.cuts)
+            cut.prepare(sampleRate, Cascade::numLanes);
+    }
+}
+
+void BatchEqEngine::reset() noexcept
+{
+    for (auto& group : groups)
+    {
+        group.cascade.reset();
+        for (auto& cut : group.cuts)
+            cut.reset();
+    }
+}
+
+void BatchEqEngine::setChannelSettings(int channel, const ChannelSettings& settings, bool immediately) noexcept
+{
+    jassert(juce::isPositiveAndBelow(channel, numChannels));
+    if (!juce::isPositiveAndBelow(channel, numChannels))
+        return;
+
+    auto& group = groups[static_cast<size_t>(channel / lanesPerGroup)];
+    const auto lane = static_cast<size_t>(channel % lanesPerGroup);
+
+    for (int band = 0; band < CoefficientBank::numBands; ++band)
+    {
+        // As in the plugin, a muted band sits flat in the cascade and is cut by its own stage instead
+        const auto& bandSettings = settings.bands[static_cast<size_t>(band)];
+        const auto& section = bank.get(band, bandSettings, settings.proportionalQ);
+        const auto* cut = bandSettings.mute && !bandSettings.bypass ? &bank.getCut(band, bandSettings.freqIndex, settings.cutLevelIndex) : nullptr;
+
+        if (immediately)
+            group.cascade.setCoefficients(static_cast<size_t>(band), lane, section);
+        else
+            group.cascade.setTargetCoefficients(static_cast<size_t>(band), lane, section);
+
+        group.cuts[static_cast<size_t>(band)].setChannel(lane, cut, immediately);
+    }
+}
+
+void BatchEqEngine::process(float* const* channels, int numSamples) noexcept
+{
+    for (size_t g = 0; g < groups.size(); ++g)
+    {
+        const auto first = static_cast<int>(g) * lanesPerGroup;
+        const auto numInGroup = juce::jmin(lanesPerGroup, numChannels - first);
+
+        auto& group = groups[g];
+        group.cascade.process(channels + first, static_cast<size_t>(numInGroup), static_cast<size_t>(numSamples));
+
+        for (auto& cut : group.cuts)
+            cut.process(channels + first, static_cast<size_t>(numInGroup), static_cast<size_t>(numSamples));
+    }
+}
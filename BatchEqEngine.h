@@ -0,0 +1,52 @@
+#pragma once
+#include <JuceHeader.h>
+#include <array>
+#include <vector>
+#include "CoefficientBank.h"
+#include "BiquadCascade.h"
+#include "BandCut.h"
+
+// Runs the EQ section on many independent channels at once, e.g. every channel of a mixing template.
+// Channels are packed into groups of one SIMD register each, and every lane carries its own band settings.
+// The sections come from the same CoefficientBank and run through the same BiquadCascade as the plugin, and
+// muted bands are cut by the same BandCut stages, so the results match the plugin for identical settings.
+// Stepped settings only, in linked mode, without saturation.
+class BatchEqEngine
+{
+public:
+    using Cascade = BiquadCascade<float, CoefficientBank::numBands>;
+    static constexpr int lanesPerGroup = static_cast<int>(Cascade::numLanes); // 8 in an AVX2 build (EQALPHA_AVX2), 4 on SSE and NEON
+
+    struct ChannelSettings
+    {
+        std::array<BandSettings, CoefficientBank::numBands> bands;
+        bool proportionalQ = false;
+        int cutLevelIndex = EqTables::defaultCutLevelIndex; // Depth of muted bands, as the MUTE_CUT choice
+    };
+
+    // Allocates one cascade per group of lanesPerGroup channels. Not realtime safe.
+    void prepare(double sampleRate, int numChannels);
+    void reset() noexcept;
+
+    int getNumChannels() const noexcept { return numChannels; }
+    const CoefficientBank& getCoefficientBank() const noexcept { return bank; }
+
+    // Glides the given channel to its new settings; immediately = true skips the ramp
+    void setChannelSettings(int channel, const ChannelSettings& settings, bool immediately = false) noexcept;
+
+    // Expects exactly getNumChannels() channel pointers
+    void process(float* const* channels, int numSamples) noexcept;
+
+private:
+    struct Group
+    {
+        Cascade cascade;
+
+        // Only processed while a lane has the band muted
+        std::array<BandCut<float, TransposedDirectFormII, Cascade::numLanes>, CoefficientBank::numBands> cuts;
+    };
+
+    CoefficientBank bank;
+    std::vector<Group> groups;
+    int numChannels = 0;
+};
@@ -0,0 +1,364 @@
+// Headless offline renderer: streams WAV/AIFF files through Api550bAudioProcessor, many files at once.
+// Built by the EQAlpha3BatchRender target (CMakeLists.txt), which compiles in the plugin's own sources.
+//
+// Usage: EQAlpha3BatchRender (--state preset.bin | --program 2) --out outputDir [--threads 8] [--block 8192]
+//                            [--suffix _eq] input1.wav input2.aiff ...
+//
+// --state takes anything getStateInformation wrote (the binary session format or the older XML), --program a
+// factory program index. Every file gets the same state, keeps its format, channel count, rate and bit depth, and
+// comes out time-aligned: the plugin's latency is trimmed from the start and flushed at the end.
+//
+// Files are memory-mapped where the format allows it and read in --block sized chunks otherwise, so nothing is
+// ever loaded whole. Output goes through a ThreadedWriter per worker. Each worker owns one processor instance and a
+// queue of files, largest first; a worker whose queue runs dry steals from the back of the others' queues.
+
+#include <JuceHeader.h>
+#include "../PluginProcessor.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <deque>
+#include <mutex>
+#include <vector>
+
+namespace
+{
+    struct Options
+    {
+        juce::File stateFile, outputDirectory;
+        int program = -1;
+        int numThreads = juce::SystemStats::getNumCpus();
+        int blockSize = 8192;
+        juce::String suffix = "_eq";
+        juce::Array<juce::File> inputs;
+    };
+
+    Options parseOptions(const juce::StringArray& args)
+    {
+        Options options;
+        const auto cwd = juce::File::getCurrentWorkingDirectory();
+
+        for (int i = 0; i < args.size(); ++i)
+        {
+            const auto hasValue = i < args.size() - 1;
+
+            if (args[i] == "--state" && hasValue)         options.stateFile = cwd.getChildFile(args[++i]);
+            else if (args[i] == "--program" && hasValue)  options.program = args[++i].getIntValue();
+            else if (args[i] == "--out" && hasValue)      options.outputDirectory = cwd.getChildFile(args[++i]);
+            else if (args[i] == "--threads" && hasValue)  options.numThreads = juce::jmax(1, args[++i].getIntValue());
+            else if (args[i] == "--block" && hasValue)    options.blockSize = juce::jlimit(64, 1 << 16, args[++i].getIntValue());
+            else if (args[i] == "--suffix" && hasValue)   options.suffix = args[++i];
+            else                                          options.inputs.add(cwd.getChildFile(args[i]));
+        }
+
+        return options;
+    }
+
+    struct Job
+    {
+        juce::File input, output;
+        juce::int64 size = 0;
+    };
+
+    struct JobResult
+    {
+        juce::File input;
+        juce::String error; // Empty on success
+        double audioSeconds = 0.0, renderSeconds = 0.0;
+    };
+
+    // One queue per worker. The owner takes from the front, thieves from the back, so they rarely meet.
+    class JobQueues
+    {
+    public:
+        explicit JobQueues(int numWorkers) : queues(static_cast<size_t>(numWorkers)) {}
+
+        // Largest first, dealt round-robin, so every worker starts on its share of the long files
+        void distribute(std::vector<Job> jobs)
+        {
+            std::sort(jobs.begin(), jobs.end(), [](const Job& a, const Job& b) { return a.size > b.size; });
+
+            for (size_t i = 0; i < jobs.size(); ++i)
+                queues[i % queues.size()].jobs.push_back(std::move(jobs[i]));
+        }
+
+        bool next(size_t worker, Job& job)
+        {
+            if (take(queues[worker], job, true))
+                return true;
+
+            for (size_t offset = 1; offset < queues.size(); ++offset)
+                if (take(queues[(worker + offset) % queues.size()], job, false))
+                    return true;
+
+            return false; // Jobs never get added once the workers run, so empty everywhere means done
+        }
+
+    private:
+        struct Queue
+        {
+            std::mutex lock;
+            std::deque<Job> jobs;
+        };
+
+        static bool take(Queue& queue, Job& job, bool fromFront)
+        {
+            const std::lock_guard<std::mutex> guard(queue.lock);
+            if (queue.jobs.empty())
+                return false;
+
+            job = fromFront ? std::move(queue.jobs.front()) : std::move(queue.jobs.back());
+            if (fromFront)
+                queue.jobs.pop_front();
+            else
+                queue.jobs.pop_back();
+
+            return true;
+        }
+
+        std::vector<Queue> queues;
+    };
+
+    class Worker : public juce::Thread
+    {
+    public:
+        Worker(int index, JobQueues& q, juce::AudioFormatManager& formats, const juce::MemoryBlock& state, int block)
+            : juce::Thread("Render " + juce::String(index)), worker(static_cast<size_t>(index)), queues(q), formatManager(formats), blockSize(block)
+        {
+            // Created and set up here, on the message thread, like a host would for an offline bounce
+            processor.setNonRealtime(true);
+            processor.setStateInformation(state.getData(), static_cast<int>(state.getSize()));
+        }
+
+        ~Worker() override { stopThread(-1); }
+
+        std::vector<JobResult> results;
+
+        void run() override
+        {
+            writerThread.startThread();
+
+            Job job;
+            while (!threadShouldExit() && queues.next(worker, job))
+                results.push_back(render(job));
+
+            writerThread.stopThread(-1);
+        }
+
+    private:
+        std::unique_ptr<juce::AudioFormatReader> openReader(const juce::File& file)
+        {
+            auto* format = formatManager.findFormatForFileExtension(file.getFileExtension());
+            if (format == nullptr)
+                return {};
+
+            // Mapping costs nothing up front; pages are only read as the render reaches them
+            if (std::unique_ptr<juce::MemoryMappedAudioFormatReader> mapped{ format->createMemoryMappedReader(file) })
+                if (mapped->mapEntireFile())
+                    return mapped;
+
+            return std::unique_ptr<juce::AudioFormatReader>(formatManager.createReaderFor(file));
+        }
+
+        JobResult render(const Job& job)
+        {
+            const auto start = std::chrono::steady_clock::now();
+            JobResult result;
+            result.input = job.input;
+
+            const auto reader = openReader(job.input);
+            if (reader == nullptr)
+            {
+                result.error = "not a readable WAV or AIFF file";
+                return result;
+            }
+
+            const auto numChannels = static_cast<int>(reader->numChannels);
+            const auto sampleRate = reader->sampleRate;
+
+            if (numChannels < 1 || numChannels > Api550bAudioProcessor::maxChannels)
+            {
+                result.error = juce::String(numChannels) + " channels, the EQ takes 1 to " + juce::String(Api550bAudioProcessor::maxChannels);
+                return result;
+            }
+
+            auto* format = formatManager.findFormatForFileExtension(job.output.getFileExtension());
+            job.output.deleteFile();
+            auto stream = job.output.createOutputStream();
+            std::unique_ptr<juce::AudioFormatWriter> writer;
+
+            if (format != nullptr && stream != nullptr)
+                writer.reset(format->createWriterFor(stream.get(), sampleRate, static_cast<unsigned int>(numChannels),
+                    reader->usesFloatingPointData ? 32 : static_cast<int>(reader->bitsPerSample), reader->metadataValues, 0));
+
+            if (writer == nullptr)
+            {
+                result.error = "could not create " + job.output.getFullPathName();
+                return result;
+            }
+
+            stream.release(); // The writer owns it now
+
+            // A few blocks of slack, so the render only waits when the disk really can't keep up
+            juce::AudioFormatWriter::ThreadedWriter output(writer.release(), writerThread, 8 * blockSize);
+
+            processor.setPlayConfigDetails(numChannels, numChannels, sampleRate, blockSize);
+            processor.prepareToPlay(sampleRate, blockSize);
+
+            juce::AudioBuffer<float> buffer(numChannels, blockSize);
+            std::vector<const float*> usefulChannels(static_cast<size_t>(numChannels));
+            juce::MidiBuffer midi;
+            const auto length = reader->lengthInSamples;
+            juce::int64 readPosition = 0, processed = 0, written = 0;
+            int latency = -1; // Known after the first block, which is when the processor settles on its settings
+
+            while (written < length && !threadShouldExit())
+            {
+                const auto numToRead = static_cast<int>(juce::jmin(static_cast<juce::int64>(blockSize), length - readPosition));
+                buffer.clear();
+
+                if (numToRead > 0)
+                    reader->read(&buffer, 0, numToRead, readPosition, true, true);
+
+                readPosition += numToRead; // Past the end the input is silence, which flushes the latency out
+                processor.processBlock(buffer, midi);
+
+                if (latency < 0)
+                    latency = processor.getLatencySamples();
+
+                // Output sample n of the file is processed sample n + latency
+                const auto blockStart = processed;
+                processed += blockSize;
+
+                const auto firstUseful = static_cast<int>(juce::jlimit(static_cast<juce::int64>(0), static_cast<juce::int64>(blockSize), latency - blockStart));
+                const auto numUseful = static_cast<int>(juce::jmin(static_cast<juce::int64>(blockSize - firstUseful), length - written));
+
+                if (numUseful > 0)
+                {
+                    for (int ch = 0; ch < numChannels; ++ch)
+                        usefulChannels[static_cast<size_t>(ch)] = buffer.getReadPointer(ch, firstUseful);
+
+                    while (!output.write(usefulChannels.data(), numUseful)) // The FIFO is full, let the writer catch up
+                        juce::Thread::sleep(1);
+
+                    written += numUseful;
+                }
+            }
+
+            processor.releaseResources();
+
+            result.audioSeconds = static_cast<double>(length) / sampleRate;
+            result.renderSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+            return result;
+        }
+
+        const size_t worker;
+        JobQueues& queues;
+        juce::AudioFormatManager& formatManager;
+        const int blockSize;
+        Api550bAudioProcessor processor;
+        juce::TimeSliceThread writerThread{ "Render writer" };
+    };
+}
+
+int main(int argc, char* argv[])
+{
+    juce::ScopedJuceInitialiser_GUI juceInitialiser; // The processor's parameters expect a message manager
+
+    juce::StringArray args;
+    for (int i = 1; i < argc; ++i)
+        args.add(argv[i]);
+
+    const auto options = parseOptions(args);
+
+    if (options.inputs.isEmpty() || options.outputDirectory == juce::File() || (options.stateFile == juce::File() && options.program < 0))
+    {
+        std::fprintf(stderr, "Usage: EQAlpha3BatchRender (--state preset.bin | --program N) --out dir [--threads N] [--block N] [--suffix _eq] inputs...\n");
+        return 2;
+    }
+
+    // Everything a worker needs goes through setStateInformation, so the factory programs are turned into a state blob
+    juce::MemoryBlock state;
+
+    if (options.stateFile != juce::File())
+    {
+        if (!options.stateFile.loadFileAsData(state))
+        {
+            std::fprintf(stderr, "Could not read %s\n", options.stateFile.getFullPathName().toRawUTF8());
+            return 1;
+        }
+    }
+    else
+    {
+        Api550bAudioProcessor source;
+        if (!juce::isPositiveAndBelow(options.program, source.getNumPrograms()))
+        {
+            std::fprintf(stderr, "There is no program %d\n", options.program);
+            return 1;
+        }
+
+        source.setCurrentProgram(options.program);
+        source.getStateInformation(state);
+    }
+
+    if (!options.outputDirectory.createDirectory())
+    {
+        std::fprintf(stderr, "Could not create %s\n", options.outputDirectory.getFullPathName().toRawUTF8());
+        return 1;
+    }
+
+    std::vector<Job> jobs;
+    for (auto& input : options.inputs)
+    {
+        Job job;
+        job.input = input;
+        job.output = options.outputDirectory.getChildFile(input.getFileNameWithoutExtension() + options.suffix + input.getFileExtension());
+        job.size = input.getSize();
+        jobs.push_back(std::move(job));
+    }
+
+    juce::AudioFormatManager formatManager;
+    formatManager.registerBasicFormats();
+
+    const auto numWorkers = juce::jmin(options.numThreads, static_cast<int>(jobs.size()));
+    JobQueues queues(numWorkers);
+    queues.distribute(std::move(jobs));
+
+    std::vector<std::unique_ptr<Worker>> workers;
+    for (int i = 0; i < numWorkers; ++i)
+        workers.push_back(std::make_unique<Worker>(i, queues, formatManager, state, options.blockSize));
+
+    const auto start = std::chrono::steady_clock::now();
+
+    for (auto& worker : workers)
+        worker->startThread();
+
+    for (auto& worker : workers)
+        worker->waitForThreadToExit(-1);
+
+    const auto wallSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    double audioSeconds = 0.0;
+    int numFailed = 0;
+
+    for (auto& worker : workers)
+    {
+        for (auto& r : worker->results)
+        {
+            if (r.error.isNotEmpty())
+            {
+                ++numFailed;
+                std::fprintf(stderr, "FAILED: %s: %s\n", r.input.getFullPathName().toRawUTF8(), r.error.toRawUTF8());
+                continue;
+            }
+
+            audioSeconds += r.audioSeconds;
+            std::printf("%-40s %10.1f s audio %10.2f s render %10.1fx\n", r.input.getFileName().toRawUTF8(), r.audioSeconds,
+                r.renderSeconds, r.audioSeconds / juce::jmax(1.0e-9, r.renderSeconds));
+        }
+    }
+
+    std::printf("\n%d files, %d failed, %d workers: %.1f s of audio in %.2f s (%.1fx real time)\n", options.inputs.size(), numFailed,
+        numWorkers, audioSeconds, wallSeconds, audioSeconds / juce::jmax(1.0e-9, wallSeconds));
+
+    return numFailed == 0 ? 0 : 1;
+}
@@ -0,0 +1,1380 @@
+// Headless benchmark for Api550bAudioProcessor.
+// Built by the EQAlpha3Benchmark target (CMakeLists.txt), which compiles in the plugin's own sources.
+//
+// Usage: EQAlpha3Benchmark [--rates 44100,48000,96000,192000] [--blocks 16,64,256,1024,4096]
+//                          [--automation 0,1,8] [--seconds 10] [--json results.json]
+//                          [--batch 64,200] [--precision float,double] [--channels 2,6,12,16]
+//                          [--state-load 100] [--continuous] [--auto-gain] [--verify] [--budget 0.25]
+//
+// --automation is the number of random parameter changes applied before each block.
+// --batch additionally runs BatchEqEngine over that many channels and reports per-core throughput.
+// --channels runs the plugin on main buses that wide (5.1 = 6, 7.1.4 = 12, third-order ambisonics = 16).
+// --precision picks the processBlock overloads to time. Every run also reports the noise floor of the
+// float filter topologies against a double reference, per sample rate.
+// --state-load loads a session with that many instances: it times constructing them, restoring the binary state into
+// the fresh instances and their first prepareToPlay, and setStateInformation for the legacy XML format.
+// --continuous times continuous mode's coefficient lookups against designing the same sections exactly, and reports
+// the largest magnitude error of the lookups, per sample rate.
+// --auto-gain times a block with auto gain on against the same block with it off, with every band boosting, per sample
+// rate and --channels entry.
+// --verify checks the plugin's output against the intended responses, at every --rates entry: the magnitude of
+// every freq/gain/shelf/Q mode combination plus mute and bypass, continuous mode, auto gain's matching, channel
+// independence, the channel link, BatchEqEngine against the plugin with a muted band, the filter state of decaying
+// tails, that binary states missing newer parameters reset them, and that processBlock never allocates under
+// automation.
+// --budget fails the run when any timed configuration needs more than that fraction of its block deadline on average.
+// Either failing makes the exit code non-zero; CTest runs both (see CMakeLists.txt), so they gate the build.
+
+#include <JuceHeader.h>
+#include "../PluginProcessor.h"
+#include "../BatchEqEngine.h"
+#include "../BiquadCascade.h"
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+#include <vector>
+
+// Every allocation of the process goes through here, so --verify can count the ones a thread makes while it is armed.
+// Memory JUCE takes with malloc directly (HeapBlock) isn't seen; the rest of the containers and objects are.
+namespace AllocationCounter
+{
+    thread_local bool armed = false;
+    thread_local int count = 0;
+
+    // Counts this thread's allocations for its lifetime
+    struct ScopedCount
+    {
+        ScopedCount() { count = 0; armed = true; }
+        ~ScopedCount() { armed = false; }
+        int get() const noexcept { return count; }
+    };
+}
+
+void* operator new(std::size_t size)
+{
+    if (AllocationCounter::armed)
+        ++AllocationCounter::count;
+
+    if (auto* p = std::malloc(size > 0 ? size : 1))
+        return p;
+
+    throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+
+namespace
+{
+    struct Options
+    {
+        juce::Array<double> sampleRates{ 44100.0, 48000.0, 96000.0, 192000.0 };
+        juce::Array<int> blockSizes{ 16, 64, 256, 1024, 4096 };
+        juce::Array<int> automationDensities{ 0, 1, 8 };
+        juce::Array<int> batchChannelCounts;
+        juce::StringArray precisions{ "float" };
+        juce::Array<int> channelCounts{ 2 };
+        int stateLoadInstances = 0;
+        bool continuous = false;
+        bool autoGain = false;
+        bool verify = false;
+        double budget = 0.0; // Fraction of the block deadline, 0 = no budget
+        double secondsPerRun = 10.0;
+        juce::File jsonFile;
+    };
+
+    struct Result
+    {
+        double sampleRate = 0.0;
+        juce::String precision;
+        int numChannels = 0, blockSize = 0, automationDensity = 0;
+        double nsPerSample = 0.0, realTimeFactor = 0.0, worstBlockMicroseconds = 0.0, worstBlockDeadlineFraction = 0.0;
+    };
+
+    template <typename ValueType>
+    juce::Array<ValueType> parseList(const juce::String& text)
+    {
+        juce::Array<ValueType> values;
+        for (auto& token : juce::StringArray::fromTokens(text, ",", {}))
+            values.add(static_cast<ValueType>(token.getDoubleValue()));
+        return values;
+    }
+
+    Options parseOptions(const juce::StringArray& args)
+    {
+        Options options;
+
+        options.verify = args.contains("--verify");
+        options.continuous = args.contains("--continuous");
+        options.autoGain = args.contains("--auto-gain");
+
+        for (int i = 0; i < args.size() - 1; ++i)
+        {
+            const auto& value = args[i + 1];
+
+            if (args[i] == "--rates")            options.sampleRates = parseList<double>(value);
+            else if (args[i] == "--blocks")      options.blockSizes = parseList<int>(value);
+            else if (args[i] == "--automation")  options.automationDensities = parseList<int>(value);
+            else if (args[i] == "--seconds")     options.secondsPerRun = value.getDoubleValue();
+            else if (args[i] == "--batch")       options.batchChannelCounts = parseList<int>(value);
+            else if (args[i] == "--precision")   options.precisions = juce::StringArray::fromTokens(value, ",", {});
+            else if (args[i] == "--channels")    options.channelCounts = parseList<int>(value);
+            else if (args[i] == "--state-load")  options.stateLoadInstances = value.getIntValue();
+            else if (args[i] == "--budget")      options.budget = value.getDoubleValue();
+            else if (args[i] == "--json")        options.jsonFile = juce::File::getCurrentWorkingDirectory().getChildFile(value);
+        }
+
+        return options;
+    }
+
+    template <typename SampleType>
+    Result runOne(double sampleRate, int numChannels, int blockSize, int automationDensity, double seconds)
+    {
+        using Clock = std::chrono::steady_clock;
+        constexpr auto isDouble = std::is_same_v<SampleType, double>;
+
+        Api550bAudioProcessor processor;
+        processor.setProcessingPrecision(isDouble ? juce::AudioProcessor::doublePrecision : juce::AudioProcessor::singlePrecision);
+        processor.setPlayConfigDetails(numChannels, numChannels, sampleRate, blockSize);
+        jassert(processor.getTotalNumInputChannels() == numChannels);
+        processor.prepareToPlay(sampleRate, blockSize);
+
+        juce::Random random(0x550b);
+        juce::AudioBuffer<SampleType> buffer(numChannels, blockSize);
+        juce::MidiBuffer midi;
+        auto& parameters = processor.getParameters();
+
+        const auto numBlocks = juce::jmax(1, static_cast<int>(seconds * sampleRate / blockSize));
+        const auto deadlineNs = 1.0e9 * blockSize / sampleRate;
+        double totalNs = 0.0, worstNs = 0.0;
+
+        for (int b = 0; b < numBlocks; ++b)
+        {
+            // White noise at a sensible level, so the saturation is actually working
+            for (int ch = 0; ch < numChannels; ++ch)
+                for (int i = 0; i < blockSize; ++i)
+                    buffer.setSample(ch, i, static_cast<SampleType>(0.25f * (random.nextFloat() * 2.0f - 1.0f)));
+
+            for (int a = 0; a < automationDensity; ++a)
+                parameters[random.nextInt(parameters.size())]->setValueNotifyingHost(random.nextFloat());
+
+            const auto start = Clock::now();
+            processor.processBlock(buffer, midi);
+            const auto elapsedNs = static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start).count());
+
+            totalNs += elapsedNs;
+            worstNs = juce::jmax(worstNs, elapsedNs);
+        }
+
+        processor.releaseResources();
+
+        Result r;
+        r.sampleRate = sampleRate;
+        r.precision = isDouble ? "double" : "float";
+        r.numChannels = numChannels;
+        r.blockSize = blockSize;
+        r.automationDensity = automationDensity;
+        r.nsPerSample = totalNs / (static_cast<double>(numBlocks) * blockSize);
+        r.realTimeFactor = (static_cast<double>(numBlocks) * deadlineNs) / juce::jmax(1.0, totalNs);
+        r.worstBlockMicroseconds = worstNs * 1.0e-3;
+        r.worstBlockDeadlineFraction = worstNs / deadlineNs;
+        return r;
+    }
+
+    struct BatchResult
+    {
+        double sampleRate = 0.0;
+        int blockSize = 0, numChannels = 0;
+        double nsPerChannelSample = 0.0, channelsInRealTime = 0.0;
+    };
+
+    // Single-threaded, so channelsInRealTime is what one core can sustain
+    BatchResult runBatch(double sampleRate, int blockSize, int numChannels, double seconds)
+    {
+        using Clock = std::chrono::steady_clock;
+
+        BatchEqEngine engine;
+        engine.prepare(sampleRate, numChannels);
+
+        juce::Random random(0x550b);
+
+        for (int ch = 0; ch < numChannels; ++ch)
+        {
+            BatchEqEngine::ChannelSettings settings;
+            settings.proportionalQ = random.nextBool();
+
+            for (auto& band : settings.bands)
+            {
+                band.freqIndex = random.nextInt(EqTables::numFreqs);
+                band.gainIndex = random.nextInt(EqTables::numGains);
+                band.shelf = random.nextBool();
+            }
+
+            engine.setChannelSettings(ch, settings, true);
+        }
+
+        juce::AudioBuffer<float> buffer(numChannels, blockSize);
+        for (int ch = 0; ch < numChannels; ++ch)
+            for (int i = 0; i < blockSize; ++i)
+                buffer.setSample(ch, i, 0.25f * (random.nextFloat() * 2.0f - 1.0f));
+
+        const auto numBlocks = juce::jmax(1, static_cast<int>(seconds * sampleRate / blockSize));
+        double totalNs = 0.0;
+
+        for (int b = 0; b < numBlocks; ++b)
+        {
+            const auto start = Clock::now();
+            engine.process(buffer.getArrayOfWritePointers(), blockSize);
+            totalNs += static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start).count());
+        }
+
+        const auto channelSamples = static_cast<double>(numBlocks) * blockSize * numChannels;
+        const auto audioNs = 1.0e9 * numBlocks * blockSize / sampleRate;
+
+        BatchResult r;
+        r.sampleRate = sampleRate;
+        r.blockSize = blockSize;
+        r.numChannels = numChannels;
+        r.nsPerChannelSample = totalNs / channelSamples;
+        r.channelsInRealTime = numChannels * audioNs / juce::jmax(1.0, totalNs);
+        return r;
+    }
+
+    struct NoiseResult
+    {
+        double sampleRate = 0.0;
+        double directFormDb = 0.0, stateVariableDb = 0.0;
+    };
+
+    // Error of the float topologies against a double TDF II running the same sections, in dB relative to
+    // the output. The low band sits at 40 Hz, +12 dB, where float direct forms suffer most at high rates.
+    NoiseResult measureNoiseFloor(double sampleRate)
+    {
+        constexpr size_t numBands = CoefficientBank::numBands;
+        constexpr size_t numSamples = 1 << 18;
+
+        CoefficientBank bank;
+        bank.prepare(sampleRate);
+
+        BiquadCascade<double, numBands> reference;
+        BiquadCascade<float, numBands> directForm;
+        BiquadCascade<float, numBands, StateVariableFilter> stateVariable;
+
+        const std::array<BandSettings, numBands> bands{ { { 0, 8, true }, { 1, 2 }, { 2, 6 }, { 6, 7, true } } };
+
+        for (size_t band = 0; band < numBands; ++band)
+        {
+            const auto& section = bank.get(static_cast<int>(band), bands[band], false);
+            reference.setCoefficients(band, section);
+            directForm.setCoefficients(band, section);
+            stateVariable.setCoefficients(band, section);
+        }
+
+        juce::Random random(0x550b);
+        std::vector<double> ref(numSamples);
+        std::vector<float> df(numSamples), sv(numSamples);
+
+        for (size_t i = 0; i < numSamples; ++i)
+        {
+            ref[i] = 0.1 * (random.nextDouble() * 2.0 - 1.0);
+            df[i] = sv[i] = static_cast<float>(ref[i]);
+        }
+
+        double* refChannels[] = { ref.data() };
+        float* dfChannels[] = { df.data() };
+        float* svChannels[] = { sv.data() };
+        reference.process(refChannels, 1, numSamples);
+        directForm.process(dfChannels, 1, numSamples);
+        stateVariable.process(svChannels, 1, numSamples);
+
+        double signalEnergy = 0.0, directFormError = 0.0, stateVariableError = 0.0;
+
+        for (size_t i = numSamples / 4; i < numSamples; ++i) // Let the 40 Hz band settle first
+        {
+            signalEnergy += ref[i] * ref[i];
+            directFormError += (df[i] - ref[i]) * (df[i] - ref[i]);
+            stateVariableError += (sv[i] - ref[i]) * (sv[i] - ref[i]);
+        }
+
+        auto toDb = [&](double error) { return 10.0 * std::log10(juce::jmax(1.0e-30, error / juce::jmax(1.0e-30, signalEnergy))); };
+
+        NoiseResult r;
+        r.sampleRate = sampleRate;
+        r.directFormDb = toDb(directFormError);
+        r.stateVariableDb = toDb(stateVariableError);
+        return r;
+    }
+
+    // Parameter IDs per band, in CoefficientBank::Band order
+    struct BandIDs
+    {
+        const juce::String& freq;
+        const juce::String& gain;
+        const juce::String* shelf;
+        const juce::String& mute;
+        const juce::String& bypass;
+    };
+
+    const BandIDs bandIDs[] = {
+        { Params::LOW_FREQ, Params::LOW_GAIN, &Params::LOW_SHELF, Params::LOW_MUTE, Params::LOW_BYPASS },
+        { Params::LM_FREQ, Params::LM_GAIN, nullptr, Params::LM_MUTE, Params::LM_BYPASS },
+        { Params::HM_FREQ, Params::HM_GAIN, nullptr, Params::HM_MUTE, Params::HM_BYPASS },
+        { Params::HIGH_FREQ, Params::HIGH_GAIN, &Params::HIGH_SHELF, Params::HIGH_MUTE, Params::HIGH_BYPASS },
+    };
+
+    struct Verifier
+    {
+        int numChecks = 0;
+        juce::StringArray failures;
+
+        void expect(bool condition, const juce::String& description)
+        {
+            ++numChecks;
+            if (!condition)
+                failures.add(description);
+        }
+    };
+
+    void setParameter(Api550bAudioProcessor& processor, const juce::String& id, float value)
+    {
+        auto* parameter = processor.apvts.getParameter(id);
+        parameter->setValueNotifyingHost(parameter->convertTo0to1(value));
+    }
+
+    // Every band flat, no saturation, minimum phase: anything left in the output is the band under test
+    void setNeutral(Api550bAudioProcessor& processor)
+    {
+        for (auto& ids : bandIDs)
+        {
+            setParameter(processor, ids.gain, static_cast<float>(EqTables::unityGainIndex));
+            setParameter(processor, ids.mute, 0.0f);
+            setParameter(processor, ids.bypass, 0.0f);
+            if (ids.shelf != nullptr)
+                setParameter(processor, *ids.shelf, 0.0f);
+        }
+
+        setParameter(processor, Params::SAT_DRIVE, 0.0f);
+        setParameter(processor, Params::SAT_OVERSAMPLING, 0.0f);
+        setParameter(processor, Params::PHASE_MODE, 0.0f);
+        setParameter(processor, Params::Q_MODE, 0.0f);
+        setParameter(processor, Params::CONTINUOUS, 0.0f);
+        setParameter(processor, Params::AUTO_GAIN, 0.0f);
+        setParameter(processor, Params::CHANNEL_LINK, 1.0f);
+    }
+
+    // The responses the front panel promises. The sections come from JUCE's own filter designs rather than
+    // BiquadDesign, which CoefficientBank uses, so a mistake in either shows up as a mismatch.
+    BiquadCoefficients makeExpectedSection(int band, double freq, double gainDb, bool shelf, bool proportionalQ, double sampleRate)
+    {
+        using Coefficients = juce::dsp::IIR::Coefficients<double>;
+        const auto gainFactor = std::pow(10.0, gainDb / 20.0);
+        const auto Q = proportionalQ ? juce::jlimit(0.7, 2.2, 1.0 + 0.2 * std::abs(gainDb)) : 1.5;
+
+        const auto designed = shelf && band == CoefficientBank::lowBand ? Coefficients::makeLowShelf(sampleRate, freq, Q, gainFactor)
+                            : shelf && band == CoefficientBank::highBand ? Coefficients::makeHighShelf(sampleRate, freq * 1.3, Q, gainFactor) // The high shelf corner sits 30% above the knob
+                            : Coefficients::makePeakFilter(sampleRate, freq, Q, gainFactor);
+
+        // Normalised, so b0 b1 b2 a1 a2
+        const auto* c = designed->getRawCoefficients();
+        return { c[0], c[1], c[2], c[3], c[4] };
+    }
+
+    BiquadCoefficients makeExpectedSection(int band, int freqIndex, int gainIndex, bool shelf, bool proportionalQ, double sampleRate)
+    {
+        const auto freq = static_cast<double>(band < 2 ? EqTables::lowFreqValues[freqIndex] : EqTables::highFreqValues[freqIndex]);
+        return makeExpectedSection(band, freq, static_cast<double>(EqTables::gainDbValues[gainIndex]), shelf, proportionalQ, sampleRate);
+    }
+
+    // Largest deviation in dB between two sections, on a log grid from 20 Hz to 0.45 fs
+    double getMaxSectionErrorDb(const BiquadCoefficients& actual, const BiquadCoefficients& expected, double sampleRate)
+    {
+        constexpr int numPoints = 64;
+        const auto lowest = 20.0, highest = 0.45 * sampleRate;
+        double maxError = 0.0;
+
+        for (int i = 0; i < numPoints; ++i)
+        {
+            const auto frequency = lowest * std::pow(highest / lowest, i / static_cast<double>(numPoints - 1));
+            const auto errorDb = 20.0 * std::log10(actual.getMagnitudeForFrequency(frequency, sampleRate) / expected.getMagnitudeForFrequency(frequency, sampleRate));
+            maxError = juce::jmax(maxError, std::abs(errorDb));
+        }
+
+        return maxError;
+    }
+
+    // Random points across every band's span and the whole gain range, in every shelf and Q mode
+    struct ContinuousPoint
+    {
+        int band;
+        float freqHz, gainDb;
+        bool shelf, proportionalQ;
+    };
+
+    std::vector<ContinuousPoint> makeContinuousPoints(int numPoints)
+    {
+        juce::Random random(0x550b);
+        std::vector<ContinuousPoint> points;
+
+        for (int i = 0; i < numPoints; ++i)
+        {
+            const auto band = random.nextInt(CoefficientBank::numBands);
+            const auto minFreq = CoefficientBank::getMinFrequency(band), maxFreq = CoefficientBank::getMaxFrequency(band);
+            points.push_back({ band, minFreq * std::pow(maxFreq / minFreq, random.nextFloat()),
+                EqTables::minContinuousGainDb + (EqTables::maxContinuousGainDb - EqTables::minContinuousGainDb) * random.nextFloat(),
+                CoefficientBank::hasShelf(band) && random.nextBool(), random.nextBool() });
+        }
+
+        return points;
+    }
+
+    struct ContinuousResult
+    {
+        double sampleRate = 0.0;
+        double tableNsPerSection = 0.0, exactNsPerSection = 0.0, maxErrorDb = 0.0;
+    };
+
+    // What continuous mode pays per automation step: a table lookup, against designing the section exactly
+    ContinuousResult measureContinuous(double sampleRate)
+    {
+        using Clock = std::chrono::steady_clock;
+        constexpr int numPoints = 4096, numPasses = 200;
+
+        ContinuousCoefficientTable table;
+        table.prepare(sampleRate);
+        const auto points = makeContinuousPoints(numPoints);
+
+        auto time = [&](auto&& getSection) {
+            volatile double sink = 0.0; // Every section is consumed, so neither loop can be optimised away
+            const auto start = Clock::now();
+            for (int pass = 0; pass < numPasses; ++pass)
+                for (auto& p : points)
+                    sink = sink + getSection(p).a1;
+            const auto elapsed = static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start).count());
+            return elapsed / (static_cast<double>(numPasses) * numPoints);
+            };
+
+        ContinuousResult r;
+        r.sampleRate = sampleRate;
+        r.tableNsPerSection = time([&](const ContinuousPoint& p) { return table.get(p.band, p.freqHz, p.gainDb, p.shelf, p.proportionalQ); });
+        r.exactNsPerSection = time([&](const ContinuousPoint& p) { return CoefficientBank::design(sampleRate, p.band, p.freqHz, p.gainDb, p.shelf, p.proportionalQ); });
+
+        for (auto& p : points)
+            r.maxErrorDb = juce::jmax(r.maxErrorDb, getMaxSectionErrorDb(table.get(p.band, p.freqHz, p.gainDb, p.shelf, p.proportionalQ),
+                makeExpectedSection(p.band, p.freqHz, p.gainDb, p.shelf, p.proportionalQ, sampleRate), sampleRate));
+
+        return r;
+    }
+
+    // Re-prepares so every section starts settled, then records the response to a unit impulse on the left
+    // channel. Long enough for a 40 Hz, +12 dB peak to decay below -120 dB.
+    std::vector<float> recordImpulseResponse(Api550bAudioProcessor& processor, double sampleRate, int length, int blockSize)
+    {
+        processor.prepareToPlay(sampleRate, blockSize);
+
+        juce::AudioBuffer<float> buffer(2, blockSize);
+        juce::MidiBuffer midi;
+        std::vector<float> response;
+        response.reserve(static_cast<size_t>(length));
+
+        for (int start = 0; start < length; start += blockSize)
+        {
+            buffer.clear();
+            if (start == 0)
+                buffer.setSample(0, 0, 1.0f);
+
+            processor.processBlock(buffer, midi);
+            for (int i = 0; i < blockSize && start + i < length; ++i)
+                response.push_back(buffer.getSample(0, i));
+        }
+
+        return response;
+    }
+
+    // Largest deviation in dB between the recorded response and the expected sections, on a log grid of FFT bins
+    double getMaxMagnitudeErrorDb(const std::vector<float>& response, const std::vector<BiquadCoefficients>& expected, double sampleRate)
+    {
+        const auto order = juce::roundToInt(std::log2(static_cast<double>(response.size())));
+        juce::dsp::FFT fft(order);
+        std::vector<float> data(2 * response.size(), 0.0f);
+        std::copy(response.begin(), response.end(), data.begin());
+        fft.performFrequencyOnlyForwardTransform(data.data());
+
+        constexpr int numPoints = 64;
+        const auto binWidth = sampleRate / static_cast<double>(response.size());
+        const auto lowest = 20.0, highest = 0.45 * sampleRate;
+        double maxError = 0.0;
+
+        for (int i = 0; i < numPoints; ++i)
+        {
+            const auto target = lowest * std::pow(highest / lowest, i / static_cast<double>(numPoints - 1));
+            const auto bin = juce::jmax(1, juce::roundToInt(target / binWidth));
+            const auto frequency = bin * binWidth;
+
+            double expectedMagnitude = 1.0;
+            for (auto& section : expected)
+                expectedMagnitude *= section.getMagnitudeForFrequency(frequency, sampleRate);
+
+            const auto errorDb = 20.0 * std::log10(juce::jmax(1.0e-12, static_cast<double>(data[static_cast<size_t>(bin)])) / expectedMagnitude);
+            maxError = juce::jmax(maxError, std::abs(errorDb));
+        }
+
+        return maxError;
+    }
+
+    void verifyResponses(Verifier& verifier, double sampleRate)
+    {
+        constexpr auto toleranceDb = 0.05;
+        constexpr int blockSize = 512;
+        const auto length = juce::nextPowerOfTwo(static_cast<int>(0.75 * sampleRate));
+
+        Api550bAudioProcessor processor;
+        processor.setPlayConfigDetails(2, 2, sampleRate, blockSize);
+
+        auto check = [&](const std::vector<BiquadCoefficients>& expected, const juce::String& description) {
+            const auto error = getMaxMagnitudeErrorDb(recordImpulseResponse(processor, sampleRate, length, blockSize), expected, sampleRate);
+            verifier.expect(error <= toleranceDb, juce::String(sampleRate, 0) + " Hz, " + description + ": off by " + juce::String(error, 3) + " dB");
+            };
+
+        for (int band = 0; band < CoefficientBank::numBands; ++band)
+        {
+            const auto& ids = bandIDs[band];
+
+            for (int shelf = 0; shelf < (ids.shelf != nullptr ? 2 : 1); ++shelf)
+            {
+                for (int propQ = 0; propQ < 2; ++propQ)
+                {
+                    for (int f = 0; f < EqTables::numFreqs; ++f)
+                    {
+                        for (int g = 0; g < EqTables::numGains; ++g)
+                        {
+                            setNeutral(processor);
+                            setParameter(processor, Params::Q_MODE, static_cast<float>(propQ));
+                            setParameter(processor, ids.freq, static_cast<float>(f));
+                            setParameter(processor, ids.gain, static_cast<float>(g));
+                            if (ids.shelf != nullptr)
+                                setParameter(processor, *ids.shelf, static_cast<float>(shelf));
+
+                            check({ makeExpectedSection(band, f, g, shelf != 0, propQ != 0, sampleRate) },
+                                juce::String::formatted("band %d freq %d gain %d shelf %d Q mode %d", band, f, g, shelf, propQ));
+                        }
+                    }
+                }
+            }
+
+            // Bypass takes the band out entirely, whatever it is set to
+            setNeutral(processor);
+            setParameter(processor, ids.gain, static_cast<float>(EqTables::numGains - 1));
+            setParameter(processor, ids.bypass, 1.0f);
+            check({}, juce::String::formatted("band %d bypassed", band));
+
+            // Mute replaces the band with its cut, each of the two sections contributing half the depth
+            for (int c = 0; c < EqTables::numCutLevels; ++c)
+            {
+                const auto f = EqTables::numFreqs / 2;
+                setNeutral(processor);
+                setParameter(processor, ids.freq, static_cast<float>(f));
+                setParameter(processor, ids.gain, static_cast<float>(EqTables::numGains - 1));
+                setParameter(processor, ids.mute, 1.0f);
+                setParameter(processor, Params::MUTE_CUT, static_cast<float>(c));
+
+                const auto freq = static_cast<double>(band < 2 ? EqTables::lowFreqValues[f] : EqTables::highFreqValues[f]);
+                const auto halfCut = std::pow(10.0, EqTables::cutDbValues[c] / 40.0);
+                const auto cut = band == CoefficientBank::lowBand ? BiquadDesign::makeLowShelf(sampleRate, freq, 0.707, halfCut)
+                               : band == CoefficientBank::highBand ? BiquadDesign::makeHighShelf(sampleRate, freq, 0.707, halfCut)
+                                                                   : BiquadDesign::makePeakFilter(sampleRate, freq, 0.707, halfCut);
+                check({ cut, cut }, juce::String::formatted("band %d muted, cut level %d", band, c));
+            }
+        }
+    }
+
+    // Continuous mode's table has to stay within its error bound everywhere, and the plugin has to run what it looks up
+    void verifyContinuous(Verifier& verifier, double sampleRate)
+    {
+        constexpr auto tableToleranceDb = 0.05;
+        const auto table = measureContinuous(sampleRate);
+        verifier.expect(table.maxErrorDb <= tableToleranceDb, juce::String(sampleRate, 0) + " Hz: continuous table off by "
+            + juce::String(table.maxErrorDb, 3) + " dB");
+
+        // End to end, the response measurement adds its own error on top of the table's
+        constexpr auto toleranceDb = 0.1;
+        constexpr int blockSize = 512;
+        const auto length = juce::nextPowerOfTwo(static_cast<int>(0.75 * sampleRate));
+        const juce::String* continuousIDs[][2] = { { &Params::LOW_FREQ_C, &Params::LOW_GAIN_C }, { &Params::LM_FREQ_C, &Params::LM_GAIN_C },
+            { &Params::HM_FREQ_C, &Params::HM_GAIN_C }, { &Params::HIGH_FREQ_C, &Params::HIGH_GAIN_C } };
+
+        Api550bAudioProcessor processor;
+        processor.setPlayConfigDetails(2, 2, sampleRate, blockSize);
+
+        for (auto& p : makeContinuousPoints(16))
+        {
+            setNeutral(processor);
+            setParameter(processor, Params::CONTINUOUS, 1.0f);
+            for (auto& ids : continuousIDs)
+                setParameter(processor, *ids[1], 0.0f);
+
+            setParameter(processor, Params::Q_MODE, p.proportionalQ ? 1.0f : 0.0f);
+            setParameter(processor, *continuousIDs[p.band][0], p.freqHz);
+            setParameter(processor, *continuousIDs[p.band][1], p.gainDb);
+            if (bandIDs[p.band].shelf != nullptr)
+                setParameter(processor, *bandIDs[p.band].shelf, p.shelf ? 1.0f : 0.0f);
+
+            // The parameters quantise what they are given, so the expectation uses what they hold
+            const auto freq = processor.apvts.getRawParameterValue(*continuousIDs[p.band][0])->load();
+            const auto gain = processor.apvts.getRawParameterValue(*continuousIDs[p.band][1])->load();
+            const auto error = getMaxMagnitudeErrorDb(recordImpulseResponse(processor, sampleRate, length, blockSize),
+                { makeExpectedSection(p.band, freq, gain, p.shelf, p.proportionalQ, sampleRate) }, sampleRate);
+            verifier.expect(error <= toleranceDb, juce::String(sampleRate, 0) + " Hz, " + juce::String::formatted("continuous band %d at %.1f Hz, %.2f dB",
+                p.band, freq, gain) + ": off by " + juce::String(error, 3) + " dB");
+        }
+    }
+
+    struct AutoGainResult
+    {
+        double sampleRate = 0.0;
+        int numChannels = 0;
+        double offNsPerSample = 0.0, onNsPerSample = 0.0;
+    };
+
+    // Two instances with every band boosting, one with auto gain on, fed the same noise a block at a time in turn,
+    // so both see the same machine state
+    AutoGainResult measureAutoGain(double sampleRate, int numChannels, double seconds)
+    {
+        using Clock = std::chrono::steady_clock;
+        constexpr int blockSize = 512;
+
+        std::array<Api550bAudioProcessor, 2> processors;
+        for (size_t i = 0; i < processors.size(); ++i)
+        {
+            auto& processor = processors[i];
+            processor.setPlayConfigDetails(numChannels, numChannels, sampleRate, blockSize);
+            setNeutral(processor);
+            for (auto& ids : bandIDs)
+                setParameter(processor, ids.gain, static_cast<float>(EqTables::numGains - 3));
+            setParameter(processor, Params::SAT_DRIVE, 2.0f);
+            setParameter(processor, Params::AUTO_GAIN, static_cast<float>(i));
+            processor.prepareToPlay(sampleRate, blockSize);
+        }
+
+        juce::Random random(0x550b);
+        juce::AudioBuffer<float> input(numChannels, blockSize), buffer(numChannels, blockSize);
+        juce::MidiBuffer midi;
+        std::array<double, 2> totalNs{};
+        const auto numBlocks = juce::jmax(1, static_cast<int>(seconds * sampleRate / blockSize));
+
+        for (int b = 0; b < numBlocks; ++b)
+        {
+            for (int ch = 0; ch < numChannels; ++ch)
+                for (int i = 0; i < blockSize; ++i)
+                    input.setSample(ch, i, 0.25f * (random.nextFloat() * 2.0f - 1.0f));
+
+            for (size_t p = 0; p < processors.size(); ++p)
+            {
+                buffer.makeCopyOf(input, true);
+                const auto start = Clock::now();
+                processors[p].processBlock(buffer, midi);
+                totalNs[p] += static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start).count());
+            }
+        }
+
+        AutoGainResult r;
+        r.sampleRate = sampleRate;
+        r.numChannels = numChannels;
+        r.offNsPerSample = totalNs[0] / (static_cast<double>(numBlocks) * blockSize);
+        r.onNsPerSample = totalNs[1] / (static_cast<double>(numBlocks) * blockSize);
+        return r;
+    }
+
+    // A tone at the centre of a +12 dB peak comes out 12 dB louder whatever the weighting, so auto gain has to settle
+    // on -12 dB and bring the output back to the input's level. Flat, it has to leave the signal alone.
+    void verifyAutoGain(Verifier& verifier, double sampleRate)
+    {
+        constexpr auto toleranceDb = 0.25;
+        constexpr int blockSize = 512;
+        const auto& highMid = bandIDs[CoefficientBank::highMidBand];
+        const auto& high = bandIDs[CoefficientBank::highBand];
+
+        Api550bAudioProcessor processor;
+        processor.setPlayConfigDetails(2, 2, sampleRate, blockSize);
+
+        // A tone through one band; returns how far the output's level ended up from the input's
+        auto run = [&](const BandIDs& ids, int freqIndex, int gainIndex, bool shelf, double frequency) {
+            setNeutral(processor);
+            setParameter(processor, ids.freq, static_cast<float>(freqIndex));
+            setParameter(processor, ids.gain, static_cast<float>(gainIndex));
+            if (ids.shelf != nullptr)
+                setParameter(processor, *ids.shelf, shelf ? 1.0f : 0.0f);
+            setParameter(processor, Params::AUTO_GAIN, 1.0f);
+            processor.prepareToPlay(sampleRate, blockSize);
+
+            juce::AudioBuffer<float> buffer(2, blockSize);
+            juce::MidiBuffer midi;
+            const auto numBlocks = static_cast<int>(10.0 * sampleRate / blockSize); // The 3 s window, then the 1 s glide several times over
+            const auto measureFrom = numBlocks - static_cast<int>(sampleRate / blockSize);
+            double inputSquares = 0.0, outputSquares = 0.0;
+            size_t n = 0;
+
+            for (int b = 0; b < numBlocks; ++b)
+            {
+                for (int i = 0; i < blockSize; ++i)
+                {
+                    const auto x = 0.1f * static_cast<float>(std::sin(juce::MathConstants<double>::twoPi * frequency * static_cast<double>(n++) / sampleRate));
+                    buffer.setSample(0, i, x);
+                    buffer.setSample(1, i, x);
+                    if (b >= measureFrom)
+                        inputSquares += static_cast<double>(x) * x;
+                }
+
+                processor.processBlock(buffer, midi);
+                if (b >= measureFrom)
+                    for (int i = 0; i < blockSize; ++i)
+                        outputSquares += static_cast<double>(buffer.getSample(0, i)) * buffer.getSample(0, i);
+            }
+
+            return 10.0 * std::log10(outputSquares / inputSquares);
+            };
+
+        const auto boostedErrorDb = run(highMid, 2, EqTables::numGains - 1, false, 3000.0); // HM_FREQ step 2
+        const auto gainDb = processor.getAutoGain().getGainDb();
+        verifier.expect(std::abs(boostedErrorDb) <= toleranceDb && std::abs(gainDb + 12.0f) <= toleranceDb, juce::String(sampleRate, 0)
+            + " Hz: auto gain left a +12 dB boost at " + juce::String(boostedErrorDb, 2) + " dB, gain " + juce::String(gainDb, 2) + " dB");
+
+        // The high shelves boost what a meter running below the full rate would only see folded down, 12 kHz to DC at 48 kHz
+        for (const auto freqIndex : { 5, 6 }) // 10k, 12.5k
+        {
+            const auto shelfErrorDb = run(high, freqIndex, EqTables::numGains - 1, true, 12000.0);
+            verifier.expect(std::abs(shelfErrorDb) <= toleranceDb, juce::String(sampleRate, 0) + " Hz: auto gain left a +12 dB "
+                + (freqIndex == 5 ? "10k" : "12.5k") + " shelf at " + juce::String(shelfErrorDb, 2) + " dB at 12 kHz");
+        }
+
+        const auto flatErrorDb = run(highMid, 2, EqTables::unityGainIndex, false, 3000.0);
+        verifier.expect(std::abs(flatErrorDb) <= 0.05, juce::String(sampleRate, 0) + " Hz: auto gain moved a flat EQ by " + juce::String(flatErrorDb, 3) + " dB");
+    }
+
+    // A binary state from before a parameter existed has to leave it at its default, as an XML session does, rather
+    // than at whatever the instance held. The older state is a current one with those parameters' entries taken out.
+    void verifyStateDefaults(Verifier& verifier)
+    {
+        const juce::String* newer[] = { &Params::AUTO_GAIN, &Params::CHANNEL_LINK };
+
+        Api550bAudioProcessor source;
+        setParameter(source, Params::LOW_GAIN, static_cast<float>(EqTables::numGains - 1));
+        juce::MemoryBlock state;
+        source.getStateInformation(state);
+
+        juce::MemoryInputStream in(state, false);
+        juce::MemoryOutputStream out;
+        out.writeInt(in.readInt()); // Magic
+        out.writeShort(in.readShort()); // Version
+
+        std::vector<std::pair<int, float>> kept;
+        const auto numParameters = static_cast<juce::uint16>(in.readShort());
+        for (int i = 0; i < numParameters; ++i)
+        {
+            const auto hash = in.readInt();
+            const auto value = in.readFloat();
+            if (std::none_of(std::begin(newer), std::end(newer), [hash](auto* id) { return static_cast<juce::uint32>(hash) == ParameterLayout::hashID(*id); }))
+                kept.emplace_back(hash, value);
+        }
+
+        out.writeShort(static_cast<short>(kept.size()));
+        for (auto& [hash, value] : kept)
+        {
+            out.writeInt(hash);
+            out.writeFloat(value);
+        }
+        out.writeFromInputStream(in, -1); // The slots
+
+        Api550bAudioProcessor target;
+        setParameter(target, Params::AUTO_GAIN, 1.0f);
+        setParameter(target, Params::CHANNEL_LINK, 0.0f);
+        target.setStateInformation(out.getData(), static_cast<int>(out.getDataSize()));
+
+        for (auto* id : newer)
+        {
+            auto* parameter = target.apvts.getParameter(*id);
+            verifier.expect(parameter->getValue() == parameter->getDefaultValue(), "Binary state without " + *id + " left it off its default");
+        }
+
+        verifier.expect(target.apvts.getRawParameterValue(Params::LOW_GAIN)->load() == static_cast<float>(EqTables::numGains - 1),
+            "Binary state without some parameters lost the ones it has");
+    }
+
+    // processBlock may never allocate, whatever the automation does: every parameter moves at random between blocks
+    template <typename SampleType>
+    void verifyNoAllocations(Verifier& verifier, double sampleRate)
+    {
+        constexpr int blockSize = 256, changesPerBlock = 8;
+        constexpr auto isDouble = std::is_same_v<SampleType, double>;
+
+        Api550bAudioProcessor processor;
+        processor.setProcessingPrecision(isDouble ? juce::AudioProcessor::doublePrecision : juce::AudioProcessor::singlePrecision);
+        processor.setPlayConfigDetails(2, 2, sampleRate, blockSize);
+        processor.prepareToPlay(sampleRate, blockSize);
+
+        juce::Random random(0x550b);
+        juce::AudioBuffer<SampleType> buffer(2, blockSize);
+        juce::MidiBuffer midi;
+        auto& parameters = processor.getParameters();
+        const auto numBlocks = static_cast<int>(2.0 * sampleRate / blockSize);
+        int numAllocations = 0;
+
+        for (int b = 0; b < numBlocks; ++b)
+        {
+            for (int ch = 0; ch < 2; ++ch)
+                for (int i = 0; i < blockSize; ++i)
+                    buffer.setSample(ch, i, static_cast<SampleType>(0.25f * (random.nextFloat() * 2.0f - 1.0f)));
+
+            // Outside the count: the host's side of a change may allocate, only the audio thread's may not
+            for (int a = 0; a < changesPerBlock; ++a)
+                parameters[random.nextInt(parameters.size())]->setValueNotifyingHost(random.nextFloat());
+
+            const AllocationCounter::ScopedCount allocations;
+            processor.processBlock(buffer, midi);
+            numAllocations += allocations.get();
+        }
+
+        processor.releaseResources();
+        verifier.expect(numAllocations == 0, juce::String(sampleRate, 0) + " Hz " + (isDouble ? "double" : "float") + ": processBlock allocated "
+            + juce::String(numAllocations) + " times under automation");
+    }
+
+    // Each channel has to come out exactly as if it had been processed alone
+    void verifyChannelIndependence(Verifier& verifier, double sampleRate)
+    {
+        constexpr int blockSize = 256, numBlocks = 64;
+
+        Api550bAudioProcessor processor;
+        processor.setPlayConfigDetails(2, 2, sampleRate, blockSize);
+        setNeutral(processor);
+        setParameter(processor, Params::LOW_GAIN, static_cast<float>(EqTables::numGains - 1));
+        setParameter(processor, Params::HM_GAIN, 0.0f);
+        setParameter(processor, Params::SAT_DRIVE, 4.0f);
+
+        auto run = [&](bool feedLeft, bool feedRight) {
+            processor.prepareToPlay(sampleRate, blockSize);
+            juce::Random random(0x550b);
+            juce::AudioBuffer<float> buffer(2, blockSize), output(2, blockSize * numBlocks);
+            juce::MidiBuffer midi;
+
+            for (int b = 0; b < numBlocks; ++b)
+            {
+                for (int i = 0; i < blockSize; ++i)
+                {
+                    const auto left = 0.25f * (random.nextFloat() * 2.0f - 1.0f);
+                    const auto right = 0.25f * (random.nextFloat() * 2.0f - 1.0f);
+                    buffer.setSample(0, i, feedLeft ? left : 0.0f);
+                    buffer.setSample(1, i, feedRight ? right : 0.0f);
+                }
+
+                processor.processBlock(buffer, midi);
+                for (int ch = 0; ch < 2; ++ch)
+                    output.copyFrom(ch, b * blockSize, buffer, ch, 0, blockSize);
+            }
+
+            return output;
+            };
+
+        const auto both = run(true, true), leftOnly = run(true, false), rightOnly = run(false, true);
+        const auto total = blockSize * numBlocks;
+        bool leftMatches = true, rightMatches = true;
+
+        for (int i = 0; i < total; ++i)
+        {
+            leftMatches = leftMatches && both.getSample(0, i) == leftOnly.getSample(0, i) && leftOnly.getSample(1, i) == 0.0f;
+            rightMatches = rightMatches && both.getSample(1, i) == rightOnly.getSample(1, i) && rightOnly.getSample(0, i) == 0.0f;
+        }
+
+        verifier.expect(leftMatches, juce::String(sampleRate, 0) + " Hz: left channel depends on the right");
+        verifier.expect(rightMatches, juce::String(sampleRate, 0) + " Hz: right channel depends on the left");
+    }
+
+    // Unlinked, each channel of a wider bus runs the band set its choice picks (by default the first on odd channels and
+    // the second on even ones); linked, every channel runs the first. The same input goes into every channel.
+    void verifyChannelLink(Verifier& verifier, double sampleRate)
+    {
+        constexpr int numChannels = 4, blockSize = 256, numBlocks = 16;
+
+        Api550bAudioProcessor processor;
+        processor.setPlayConfigDetails(numChannels, numChannels, sampleRate, blockSize);
+        setNeutral(processor);
+        setParameter(processor, Params::LOW_GAIN, static_cast<float>(EqTables::numGains - 1));
+        setParameter(processor, Params::LOW_GAIN_B, 0.0f);
+
+        auto run = [&](bool linked) {
+            setParameter(processor, Params::CHANNEL_LINK, linked ? 1.0f : 0.0f);
+            processor.prepareToPlay(sampleRate, blockSize);
+            juce::Random random(0x550b);
+            juce::AudioBuffer<float> buffer(numChannels, blockSize), output(numChannels, blockSize * numBlocks);
+            juce::MidiBuffer midi;
+
+            for (int b = 0; b < numBlocks; ++b)
+            {
+                for (int i = 0; i < blockSize; ++i)
+                {
+                    const auto sample = 0.25f * (random.nextFloat() * 2.0f - 1.0f);
+                    for (int ch = 0; ch < numChannels; ++ch)
+                        buffer.setSample(ch, i, sample);
+                }
+
+                processor.processBlock(buffer, midi);
+                for (int ch = 0; ch < numChannels; ++ch)
+                    output.copyFrom(ch, b * blockSize, buffer, ch, 0, blockSize);
+            }
+
+            return output;
+            };
+
+        auto sameChannels = [](const juce::AudioBuffer<float>& buffer, int a, int b) {
+            for (int i = 0; i < buffer.getNumSamples(); ++i)
+                if (buffer.getSample(a, i) != buffer.getSample(b, i))
+                    return false;
+
+            return true;
+            };
+
+        const auto linked = run(true), unlinked = run(false);
+        verifier.expect(sameChannels(linked, 0, 1) && sameChannels(linked, 0, 3), juce::String(sampleRate, 0) + " Hz: linked channels differ");
+        verifier.expect(sameChannels(unlinked, 0, 2) && sameChannels(unlinked, 1, 3), juce::String(sampleRate, 0) + " Hz: unlinked channels on the same band set differ");
+        verifier.expect(!sameChannels(unlinked, 0, 1), juce::String(sampleRate, 0) + " Hz: unlinked channels on different band sets match");
+    }
+
+    // BatchEqEngine has to sound like the plugin for the same settings, muted bands included. One engine channel
+    // has the low mid band muted and one doesn't, so a cut that leaks into the wrong lane fails as well.
+    void verifyBatchEngine(Verifier& verifier, double sampleRate)
+    {
+        constexpr auto tolerance = 1.0e-4f; // The plugin's float path is an SVF, the engine's a TDF II
+        constexpr int blockSize = 512;
+        const auto length = juce::nextPowerOfTwo(static_cast<int>(0.5 * sampleRate));
+
+        Api550bAudioProcessor processor;
+        processor.setPlayConfigDetails(2, 2, sampleRate, blockSize);
+        setNeutral(processor);
+        setParameter(processor, Params::LOW_GAIN, static_cast<float>(EqTables::numGains - 1));
+        setParameter(processor, Params::LM_GAIN, static_cast<float>(EqTables::numGains - 1));
+        setParameter(processor, Params::HM_GAIN, 0.0f);
+        setParameter(processor, Params::MUTE_CUT, static_cast<float>(EqTables::numCutLevels - 1));
+
+        // The processor's current settings, as the engine takes them
+        auto readSettings = [&] {
+            auto value = [&](const juce::String& id) { return processor.apvts.getRawParameterValue(id)->load(); };
+
+            BatchEqEngine::ChannelSettings settings;
+            settings.proportionalQ = value(Params::Q_MODE) >= 0.5f;
+            settings.cutLevelIndex = juce::roundToInt(value(Params::MUTE_CUT));
+
+            for (size_t band = 0; band < settings.bands.size(); ++band)
+            {
+                const auto& ids = bandIDs[band];
+                auto& b = settings.bands[band];
+                b.freqIndex = juce::roundToInt(value(ids.freq));
+                b.gainIndex = juce::roundToInt(value(ids.gain));
+                b.shelf = ids.shelf != nullptr && value(*ids.shelf) >= 0.5f;
+                b.mute = value(ids.mute) >= 0.5f;
+                b.bypass = value(ids.bypass) >= 0.5f;
+            }
+
+            return settings;
+            };
+
+        const auto unmutedSettings = readSettings();
+        const auto unmuted = recordImpulseResponse(processor, sampleRate, length, blockSize);
+        setParameter(processor, Params::LM_MUTE, 1.0f);
+        const auto mutedSettings = readSettings();
+        const auto muted = recordImpulseResponse(processor, sampleRate, length, blockSize);
+
+        BatchEqEngine engine;
+        engine.prepare(sampleRate, 2);
+        engine.setChannelSettings(0, mutedSettings, true);
+        engine.setChannelSettings(1, unmutedSettings, true);
+
+        juce::AudioBuffer<float> buffer(2, blockSize);
+        float mutedError = 0.0f, unmutedError = 0.0f;
+
+        for (int start = 0; start < length; start += blockSize)
+        {
+            buffer.clear();
+            if (start == 0)
+                for (int ch = 0; ch < 2; ++ch)
+                    buffer.setSample(ch, 0, 1.0f);
+
+            engine.process(buffer.getArrayOfWritePointers(), blockSize);
+
+            for (int i = 0; i < blockSize && start + i < length; ++i)
+            {
+                const auto n = static_cast<size_t>(start + i);
+                mutedError = juce::jmax(mutedError, std::abs(buffer.getSample(0, i) - muted[n]));
+                unmutedError = juce::jmax(unmutedError, std::abs(buffer.getSample(1, i) - unmuted[n]));
+            }
+        }
+
+        verifier.expect(mutedError <= tolerance, juce::String(sampleRate, 0) + " Hz: batch engine differs from the plugin with a muted band, by "
+            + juce::String(mutedError, 6));
+        verifier.expect(unmutedError <= tolerance, juce::String(sampleRate, 0) + " Hz: batch engine differs from the plugin next to a muted lane, by "
+            + juce::String(unmutedError, 6));
+    }
+
+    // A ringing tail decays through the subnormal range, where most CPUs take many times as long per sample.
+    // Checked on the values rather than on timings: no filter state may ever hold a subnormal.
+    void verifyTailState(Verifier& verifier, double sampleRate)
+    {
+        constexpr int blockSize = 256;
+        constexpr auto tailSeconds = 10.0; // The slowest band's decay from an impulse past double's normal range
+
+        CoefficientBank bank;
+        bank.prepare(sampleRate);
+
+        // The processor's own chain types, driven directly, because the processor would skip the silence as idle.
+        // Every band is a +12 dB peak at its lowest frequency, the slowest decay there is.
+        auto run = [&](auto& chain, const char* precision) {
+            using SampleType = typename std::remove_reference_t<decltype(chain.eqCascade)>::Group::Vec::ElementType;
+
+            chain.prepare({ sampleRate, static_cast<juce::uint32>(blockSize), 2 });
+            for (int band = 0; band < CoefficientBank::numBands; ++band)
+                chain.setBand(band, bank.get(band, 0, EqTables::numGains - 1, false, false), nullptr);
+            chain.snapFiltersToTargets();
+
+            juce::AudioBuffer<SampleType> buffer(2, blockSize);
+            const auto numBlocks = static_cast<int>(tailSeconds * sampleRate / blockSize);
+            juce::ScopedNoDenormals noDenormals; // As processBlock runs
+            int subnormalBlock = -1;
+
+            for (int b = 0; b < numBlocks && subnormalBlock < 0; ++b)
+            {
+                buffer.clear(); // True silence after the impulse
+                if (b == 0)
+                    buffer.setSample(0, 0, SampleType(1));
+
+                chain.processFilters(buffer.getArrayOfWritePointers(), 2, static_cast<size_t>(blockSize));
+                if (chain.eqCascade.hasSubnormalState())
+                    subnormalBlock = b;
+            }
+
+            verifier.expect(subnormalBlock < 0, juce::String(sampleRate, 0) + " Hz: " + precision + " filter state went subnormal "
+                + juce::String(static_cast<double>(subnormalBlock) * blockSize / sampleRate, 2) + " s into the tail");
+            };
+
+        ProcessingChain<float, StateVariableFilter> floatChain;
+        ProcessingChain<double, TransposedDirectFormII> doubleChain;
+        run(floatChain, "float");
+        run(doubleChain, "double");
+    }
+
+    struct StateLoadResult
+    {
+        int numInstances = 0;
+        size_t xmlBytes = 0, binaryBytes = 0;
+        double constructMicroseconds = 0.0, prepareMicroseconds = 0.0; // Per instance
+        double xmlMicroseconds = 0.0, binaryMicroseconds = 0.0; // Per instance
+        double sessionMicroseconds() const noexcept { return constructMicroseconds + binaryMicroseconds; }
+    };
+
+    // What a session with many instances pays on load, in the order a host goes: create every instance, restore its
+    // state, then start playback. Every instance gets the same non-default state, so each load really changes every
+    // parameter.
+    StateLoadResult measureStateLoad(int numInstances)
+    {
+        juce::MemoryBlock binaryState, xmlState;
+        {
+            Api550bAudioProcessor source;
+            juce::Random random(0x550b);
+            for (auto* parameter : source.getParameters())
+                parameter->setValueNotifyingHost(random.nextFloat());
+
+            source.getStateInformation(binaryState);
+            if (auto xml = source.apvts.copyState().createXml())
+                juce::AudioProcessor::copyXmlToBinary(*xml, xmlState);
+        }
+
+        auto timePerInstance = [numInstances](auto&& fn) {
+            const auto start = std::chrono::steady_clock::now();
+            fn();
+            return std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count() / numInstances;
+            };
+
+        std::vector<std::unique_ptr<Api550bAudioProcessor>> processors;
+        auto createInstances = [&] {
+            processors.clear();
+            for (int i = 0; i < numInstances; ++i)
+                processors.push_back(std::make_unique<Api550bAudioProcessor>());
+            };
+
+        auto loadAll = [&](const juce::MemoryBlock& state) {
+            for (auto& processor : processors)
+                processor->setStateInformation(state.getData(), static_cast<int>(state.getSize()));
+            };
+
+        StateLoadResult r;
+        r.numInstances = numInstances;
+        r.xmlBytes = xmlState.getSize();
+        r.binaryBytes = binaryState.getSize();
+        r.constructMicroseconds = timePerInstance(createInstances);
+        r.binaryMicroseconds = timePerInstance([&] { loadAll(binaryState); });
+        r.prepareMicroseconds = timePerInstance([&] {
+            for (auto& processor : processors)
+                processor->prepareToPlay(48000.0, 512);
+            });
+
+        createInstances(); // Fresh instances again, so the XML loads change as much as the binary ones did
+        r.xmlMicroseconds = timePerInstance([&] { loadAll(xmlState); });
+        return r;
+    }
+
+    juce::var toJson(const juce::Array<Result>& results, const juce::Array<BatchResult>& batchResults, const juce::Array<NoiseResult>& noiseResults,
+        const juce::Array<StateLoadResult>& stateLoadResults, const juce::Array<ContinuousResult>& continuousResults,
+        const juce::Array<AutoGainResult>& autoGainResults)
+    {
+        juce::Array<juce::var> runs;
+
+        for (auto& r : results)
+        {
+            auto* run = new juce::DynamicObject();
+            run->setProperty("sampleRate", r.sampleRate);
+            run->setProperty("precision", r.precision);
+            run->setProperty("numChannels", r.numChannels);
+            run->setProperty("blockSize", r.blockSize);
+            run->setProperty("automationDensity", r.automationDensity);
+            run->setProperty("nsPerSample", r.nsPerSample);
+            run->setProperty("realTimeFactor", r.realTimeFactor);
+            run->setProperty("worstBlockMicroseconds", r.worstBlockMicroseconds);
+            run->setProperty("worstBlockDeadlineFraction", r.worstBlockDeadlineFraction);
+            runs.add(juce::var(run));
+        }
+
+        juce::Array<juce::var> batchRuns;
+
+        for (auto& r : batchResults)
+        {
+            auto* run = new juce::DynamicObject();
+            run->setProperty("sampleRate", r.sampleRate);
+            run->setProperty("blockSize", r.blockSize);
+            run->setProperty("numChannels", r.numChannels);
+            run->setProperty("nsPerChannelSample", r.nsPerChannelSample);
+            run->setProperty("channelsInRealTime", r.channelsInRealTime);
+            batchRuns.add(juce::var(run));
+        }
+
+        juce::Array<juce::var> noiseRuns;
+
+        for (auto& r : noiseResults)
+        {
+            auto* run = new juce::DynamicObject();
+            run->setProperty("sampleRate", r.sampleRate);
+            run->setProperty("floatDirectFormErrorDb", r.directFormDb);
+            run->setProperty("floatStateVariableErrorDb", r.stateVariableDb);
+            noiseRuns.add(juce::var(run));
+        }
+
+        juce::Array<juce::var> stateLoadRuns;
+
+        for (auto& r : stateLoadResults)
+        {
+            auto* run = new juce::DynamicObject();
+            run->setProperty("numInstances", r.numInstances);
+            run->setProperty("xmlBytes", static_cast<int>(r.xmlBytes));
+            run->setProperty("binaryBytes", static_cast<int>(r.binaryBytes));
+            run->setProperty("constructMicrosecondsPerInstance", r.constructMicroseconds);
+            run->setProperty("xmlMicrosecondsPerInstance", r.xmlMicroseconds);
+            run->setProperty("binaryMicrosecondsPerInstance", r.binaryMicroseconds);
+            run->setProperty("sessionLoadMicrosecondsPerInstance", r.sessionMicroseconds());
+            run->setProperty("firstPrepareMicrosecondsPerInstance", r.prepareMicroseconds);
+            stateLoadRuns.add(juce::var(run));
+        }
+
+        juce::Array<juce::var> continuousRuns;
+
+        for (auto& r : continuousResults)
+        {
+            auto* run = new juce::DynamicObject();
+            run->setProperty("sampleRate", r.sampleRate);
+            run->setProperty("tableNsPerSection", r.tableNsPerSection);
+            run->setProperty("exactNsPerSection", r.exactNsPerSection);
+            run->setProperty("maxErrorDb", r.maxErrorDb);
+            continuousRuns.add(juce::var(run));
+        }
+
+        juce::Array<juce::var> autoGainRuns;
+
+        for (auto& r : autoGainResults)
+        {
+            auto* run = new juce::DynamicObject();
+            run->setProperty("sampleRate", r.sampleRate);
+            run->setProperty("numChannels", r.numChannels);
+            run->setProperty("offNsPerSample", r.offNsPerSample);
+            run->setProperty("onNsPerSample", r.onNsPerSample);
+            autoGainRuns.add(juce::var(run));
+        }
+
+        auto* root = new juce::DynamicObject();
+        root->setProperty("plugin", "EQAlpha3");
+        root->setProperty("timestamp", juce::Time::getCurrentTime().toISO8601(true));
+        root->setProperty("runs", runs);
+        root->setProperty("batchRuns", batchRuns);
+        root->setProperty("noiseFloor", noiseRuns);
+        root->setProperty("stateLoad", stateLoadRuns);
+        root->setProperty("continuous", continuousRuns);
+        root->setProperty("autoGain", autoGainRuns);
+        return juce::var(root);
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    juce::ScopedJuceInitialiser_GUI juceInitialiser; // The processor's parameters expect a message manager
+
+    juce::StringArray args;
+    for (int i = 1; i < argc; ++i)
+        args.add(argv[i]);
+
+    const auto options = parseOptions(args);
+    juce::Array<Result> results;
+    juce::Array<BatchResult> batchResults;
+    juce::Array<NoiseResult> noiseResults;
+    juce::Array<StateLoadResult> stateLoadResults;
+    juce::Array<ContinuousResult> continuousResults;
+    juce::Array<AutoGainResult> autoGainResults;
+
+    std::printf("%10s %9s %8s %7s %6s %12s %12s %14s %10s\n", "rate", "precision", "channels", "block", "auto", "ns/sample", "RT factor", "worst block us", "% deadline");
+
+    for (auto sampleRate : options.sampleRates)
+    {
+        for (auto& precision : options.precisions)
+        {
+            for (auto numChannels : options.channelCounts)
+            {
+                for (auto blockSize : options.blockSizes)
+                {
+                    for (auto density : options.automationDensities)
+                    {
+                        const auto r = precision == "double" ? runOne<double>(sampleRate, numChannels, blockSize, density, options.secondsPerRun)
+                                                             : runOne<float>(sampleRate, numChannels, blockSize, density, options.secondsPerRun);
+                        results.add(r);
+
+                        std::printf("%10.0f %9s %8d %7d %6d %12.2f %12.1f %14.2f %10.2f\n", r.sampleRate, r.precision.toRawUTF8(), r.numChannels,
+                            r.blockSize, r.automationDensity, r.nsPerSample, r.realTimeFactor, r.worstBlockMicroseconds, 100.0 * r.worstBlockDeadlineFraction);
+                    }
+                }
+            }
+        }
+    }
+
+    std::printf("\n%10s %22s %22s\n", "rate", "float TDF II error dB", "float SVF error dB");
+
+    for (auto sampleRate : options.sampleRates)
+    {
+        const auto r = measureNoiseFloor(sampleRate);
+        noiseResults.add(r);
+        std::printf("%10.0f %22.1f %22.1f\n", r.sampleRate, r.directFormDb, r.stateVariableDb);
+    }
+
+    if (!options.batchChannelCounts.isEmpty())
+    {
+        std::printf("\n%10s %7s %9s %18s %18s\n", "rate", "block", "channels", "ns/channel-sample", "RT channels/core");
+
+        for (auto sampleRate : options.sampleRates)
+        {
+            for (auto blockSize : options.blockSizes)
+            {
+                for (auto numChannels : options.batchChannelCounts)
+                {
+                    const auto r = runBatch(sampleRate, blockSize, numChannels, options.secondsPerRun);
+                    batchResults.add(r);
+
+                    std::printf("%10.0f %7d %9d %18.3f %18.1f\n", r.sampleRate, r.blockSize, r.numChannels,
+                        r.nsPerChannelSample, r.channelsInRealTime);
+                }
+            }
+        }
+    }
+
+    if (options.stateLoadInstances > 0)
+    {
+        const auto r = measureStateLoad(options.stateLoadInstances);
+        stateLoadResults.add(r);
+
+        std::printf("\n%10s %8s %10s %16s\n", "format", "bytes", "instances", "us/instance");
+        std::printf("%10s %8d %10d %16.2f\n", "xml", static_cast<int>(r.xmlBytes), r.numInstances, r.xmlMicroseconds);
+        std::printf("%10s %8d %10d %16.2f\n", "binary", static_cast<int>(r.binaryBytes), r.numInstances, r.binaryMicroseconds);
+
+        // Instantiate + restore is what the session costs before it can play; the first prepare is where the DSP is set up
+        std::printf("\n%10s %16s %16s %16s %16s\n", "instances", "construct us", "restore us", "session us", "1st prepare us");
+        std::printf("%10d %16.2f %16.2f %16.2f %16.2f\n", r.numInstances, r.constructMicroseconds, r.binaryMicroseconds,
+            r.sessionMicroseconds(), r.prepareMicroseconds);
+    }
+
+    if (options.continuous)
+    {
+        std::printf("\n%10s %16s %16s %9s %14s\n", "rate", "table ns/section", "exact ns/section", "speedup", "max error dB");
+
+        for (auto sampleRate : options.sampleRates)
+        {
+            const auto r = measureContinuous(sampleRate);
+            continuousResults.add(r);
+            std::printf("%10.0f %16.1f %16.1f %9.1f %14.4f\n", r.sampleRate, r.tableNsPerSection, r.exactNsPerSection,
+                r.exactNsPerSection / juce::jmax(1.0e-3, r.tableNsPerSection), r.maxErrorDb);
+        }
+    }
+
+    if (options.autoGain)
+    {
+        std::printf("\n%10s %8s %14s %14s %10s\n", "rate", "channels", "off ns/sample", "on ns/sample", "overhead");
+
+        for (auto sampleRate : options.sampleRates)
+        {
+            for (auto numChannels : options.channelCounts)
+            {
+                const auto r = measureAutoGain(sampleRate, numChannels, options.secondsPerRun);
+                autoGainResults.add(r);
+                std::printf("%10.0f %8d %14.2f %14.2f %9.1f%%\n", r.sampleRate, r.numChannels, r.offNsPerSample, r.onNsPerSample,
+                    100.0 * (r.onNsPerSample / juce::jmax(1.0e-3, r.offNsPerSample) - 1.0));
+            }
+        }
+    }
+
+    Verifier verifier;
+
+    if (options.budget > 0.0)
+    {
+        for (auto& r : results)
+            verifier.expect(1.0 / r.realTimeFactor <= options.budget, juce::String::formatted("%.0f Hz %s, %d channels, block %d, automation %d: %.1f%% of the deadline",
+                r.sampleRate, r.precision.toRawUTF8(), r.numChannels, r.blockSize, r.automationDensity, 100.0 / r.realTimeFactor));
+    }
+
+    if (options.verify)
+    {
+        verifyStateDefaults(verifier);
+
+        for (auto sampleRate : options.sampleRates)
+        {
+            verifyResponses(verifier, sampleRate);
+            verifyContinuous(verifier, sampleRate);
+            verifyAutoGain(verifier, sampleRate);
+            verifyChannelIndependence(verifier, sampleRate);
+            verifyChannelLink(verifier, sampleRate);
+            verifyBatchEngine(verifier, sampleRate);
+            verifyTailState(verifier, sampleRate);
+            verifyNoAllocations<float>(verifier, sampleRate);
+            verifyNoAllocations<double>(verifier, sampleRate);
+        }
+    }
+
+    if (verifier.numChecks > 0)
+    {
+        std::printf("\n%d checks, %d failed\n", verifier.numChecks, verifier.failures.size());
+        for (auto& failure : verifier.failures)
+            std::printf("FAILED: %s\n", failure.toRawUTF8());
+    }
+
+    if (options.jsonFile != juce::File())
+    {
+        if (!options.jsonFile.replaceWithText(juce::JSON::toString(toJson(results, batchResults, noiseResults, stateLoadResults, continuousResults, autoGainResults))))
+        {
+            std::fprintf(stderr, "Could not write %s\n", options.jsonFile.getFullPathName().toRawUTF8());
+            return 1;
+        }
+    }
+
+    return verifier.failures.isEmpty() ? 0 : 1;
+}
@@ -0,0 +1,256 @@
+#pragma once
+#include <JuceHeader.h>
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include "BiquadCoefficients.h"
+#include "BiquadTopologies.h"
+
+// A fixed chain of biquads that runs several channels at once, one channel per SIMD lane.
+// Every lane has its own filter state, and its own coefficients if setCoefficients is called per lane.
+// Stages that have settled on a flat section in every lane are skipped until they're needed again.
+// The topology (see BiquadTopologies.h) is transposed direct form II unless asked otherwise.
+template <typename SampleType, size_t numStages, template <typename> class Topology = TransposedDirectFormII>
+class BiquadCascade
+{
+public:
+    using Vec = juce::dsp::SIMDRegister<SampleType>;
+    static constexpr size_t numLanes = Vec::SIMDNumElements;
+
+    // Coefficient ramps advance once every subBlockSize samples rather than once per sample. The count runs on
+    // across calls, so a glide takes the same time whatever size the blocks come in.
+    static constexpr size_t subBlockSize = 32;
+
+    BiquadCascade()
+    {
+        for (size_t stage = 0; stage < numStages; ++stage)
+            setCoefficients(stage, BiquadCoefficients{});
+
+        reset();
+    }
+
+    // Sets how long a change of coefficients takes to glide in
+    void prepare(double sampleRate, double rampLengthSeconds = 0.02) noexcept
+    {
+        rampSteps = juce::jmax(1, juce::roundToInt(rampLengthSeconds * sampleRate / static_cast<double>(subBlockSize)));
+    }
+
+    void reset() noexcept
+    {
+        for (auto& s : stages)
+            s.clearState();
+
+        rampPhase = 0;
+    }
+
+    // Immediate change, for use when the stream is (re)started
+    void setCoefficients(size_t stage, const BiquadCoefficients& c) noexcept
+    {
+        jassert(stage < numStages);
+        auto& s = stages[stage];
+        s.setTarget(c);
+        s.current = s.target;
+        s.stepsRemaining = 0;
+    }
+
+    void setCoefficients(size_t stage, size_t lane, const BiquadCoefficients& c) noexcept
+    {
+        jassert(stage < numStages && lane < numLanes);
+        auto& s = stages[stage];
+        s.setTarget(lane, c);
+        s.current.setLane(lane, c);
+    }
+
+    // Glides towards the new coefficients over the ramp length. Every topology ramps along a path
+    // that stays stable between two stable sections, so this can't blow up.
+    void setTargetCoefficients(size_t stage, const BiquadCoefficients& c) noexcept
+    {
+        jassert(stage < numStages);
+        stages[stage].setTarget(c);
+        startRamp(stages[stage]);
+    }
+
+    void setTargetCoefficients(size_t stage, size_t lane, const BiquadCoefficients& c) noexcept
+    {
+        jassert(stage < numStages && lane < numLanes);
+        stages[stage].setTarget(lane, c);
+        startRamp(stages[stage]);
+    }
+
+    // Glides over the given number of sub-blocks instead of the ramp length, for sections that are retargeted
+    // continuously. One sub-block means the new section is in place from the next sub-block on.
+    void glideToCoefficients(size_t stage, const BiquadCoefficients& c, int numSubBlocks) noexcept
+    {
+        jassert(stage < numStages);
+        stages[stage].setTarget(c);
+        startRamp(stages[stage], juce::jmax(1, numSubBlocks));
+    }
+
+    bool isRamping() const noexcept
+    {
+        for (auto& s : stages)
+            if (s.stepsRemaining > 0)
+                return true;
+
+        return false;
+    }
+
+    void snapToTargets() noexcept
+    {
+        for (auto& s : stages)
+        {
+            s.current = s.target;
+            s.stepsRemaining = 0;
+        }
+    }
+
+    // For tests: a decaying tail that reaches the subnormal range costs most CPUs many times a normal sample
+    bool hasSubnormalState() const noexcept
+    {
+        for (auto& s : stages)
+            for (size_t lane = 0; lane < numLanes; ++lane)
+                if (std::fpclassify(s.s1.get(lane)) == FP_SUBNORMAL || std::fpclassify(s.s2.get(lane)) == FP_SUBNORMAL)
+                    return true;
+
+        return false;
+    }
+
+    // Encodes channels 0 and 1 to mid and side as they're loaded into the lanes, so the sections run on
+    // M/S without a separate pass over the buffer. The output stays encoded.
+    void setMidSideEncoding(bool shouldEncode) noexcept { encodeMidSide = shouldEncode; }
+
+    // Processes up to numLanes channels in place. Channel n always runs in lane n.
+    void process(SampleType* const* channels, size_t numChannels, size_t numSamples) noexcept
+    {
+        jassert(numChannels <= numLanes);
+        numChannels = juce::jmin(numChannels, numLanes);
+        const auto encode = encodeMidSide && numChannels >= 2;
+
+        alignas(sizeof(Vec)) SampleType frame[numLanes] = {};
+
+        // Work on a local copy so the state can live in registers instead of being
+        // reloaded after every store to the (possibly aliasing) channel pointers
+        auto local = stages;
+        std::array<Stage*, numStages> active{};
+
+        for (size_t start = 0, end = 0; start < numSamples; start = end)
+        {
+            // Up to the next step of the ramps, which falls where the last call left off counting
+            const auto stepsHere = rampPhase == 0;
+            end = juce::jmin(numSamples, start + subBlockSize - rampPhase);
+            rampPhase = (rampPhase + end - start) % subBlockSize;
+            size_t numActive = 0;
+
+            for (auto& s : local)
+            {
+                if (stepsHere)
+                    s.advanceRamp();
+
+                s.updateSkipping();
+
+                if (!s.skipped)
+                    active[numActive++] = &s;
+            }
+
+            if (numActive == 0 && !encode)
+                continue;
+
+            for (size_t i = start; i < end; ++i)
+            {
+                for (size_t ch = 0; ch < numChannels; ++ch)
+                    frame[ch] = channels[ch][i];
+
+                if (encode)
+                {
+                    const auto left = frame[0], right = frame[1];
+                    frame[0] = SampleType(0.5) * (left + right);
+                    frame[1] = SampleType(0.5) * (left - right);
+                }
+
+                auto x = Vec::fromRawArray(frame);
+
+                for (size_t n = 0; n < numActive; ++n)
+                {
+                    auto& s = *active[n];
+                    x = Topology<SampleType>::tick(s.current, s.s1, s.s2, x);
+                }
+
+                x.copyToRawArray(frame);
+
+                for (size_t ch = 0; ch < numChannels; ++ch)
+                    channels[ch][i] = frame[ch];
+            }
+        }
+
+        stages = local;
+    }
+
+private:
+    using Coefficients = typename Topology<SampleType>::Coefficients;
+
+    struct Stage
+    {
+        Coefficients current, target, delta;
+        Vec s1, s2;
+        int stepsRemaining = 0;
+        std::array<bool, numLanes> laneIsFlat{};
+        bool targetIsFlat = false, skipped = false;
+
+        void setTarget(const BiquadCoefficients& c) noexcept
+        {
+            target.setAll(c);
+            laneIsFlat.fill(c.isIdentity());
+            targetIsFlat = c.isIdentity();
+            skipped = skipped && targetIsFlat;
+        }
+
+        void setTarget(size_t lane, const BiquadCoefficients& c) noexcept
+        {
+            target.setLane(lane, c);
+            laneIsFlat[lane] = c.isIdentity();
+            targetIsFlat = std::all_of(laneIsFlat.begin(), laneIsFlat.end(), [](bool b) { return b; });
+            skipped = skipped && targetIsFlat;
+        }
+
+        void clearState() noexcept
+        {
+            s1 = s2 = Vec::expand(SampleType(0));
+        }
+
+        void updateSkipping() noexcept
+        {
+            if (skipped || stepsRemaining != 0 || !targetIsFlat || !Topology<SampleType>::canSkipFlat(s1, s2))
+                return;
+
+            clearState();
+            skipped = true;
+        }
+
+        void advanceRamp() noexcept
+        {
+            if (stepsRemaining == 0)
+                return;
+
+            if (--stepsRemaining == 0)
+            {
+                current = target;
+                return;
+            }
+
+            current.advance(delta);
+        }
+    };
+
+    void startRamp(Stage& s) noexcept { startRamp(s, rampSteps); }
+
+    void startRamp(Stage& s, int numSteps) noexcept
+    {
+        s.delta.setStep(s.current, s.target, SampleType(1) / static_cast<SampleType>(numSteps));
+        s.stepsRemaining = numSteps;
+    }
+
+    std::array<Stage, numStages> stages;
+    int rampSteps = 1;
+    size_t rampPhase = 0; // Samples since the ramps last stepped
+    bool encodeMidSide = false;
+};
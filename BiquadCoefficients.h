@@ -0,0 +1,108 @@
+#pragma once
+#include <JuceHeader.h>
+#include <cmath>
+#include <complex>
+
+// Plain second-order section, normalised so that a0 == 1.
+// Unlike juce::dsp::IIR::Coefficients this is a POD that can be copied around on the audio thread freely.
+struct BiquadCoefficients
+{
+    double b0 = 1.0, b1 = 0.0, b2 = 0.0, a1 = 0.0, a2 = 0.0;
+
+    double getMagnitudeForFrequency(double frequency, double sampleRate) const noexcept
+    {
+        const auto w = juce::MathConstants<double>::twoPi * frequency / sampleRate;
+        const std::complex<double> z1 = std::polar(1.0, -w), z2 = z1 * z1;
+        return std::abs((b0 + b1 * z1 + b2 * z2) / (1.0 + a1 * z1 + a2 * z2));
+    }
+
+    // True when the zeros cancel the poles exactly, which is what every 0 dB peak or shelf designs to
+    bool isIdentity() const noexcept
+    {
+        return b0 == 1.0 && b1 == a1 && b2 == a2;
+    }
+
+    // Samples until the impulse response has decayed by the given factor, from the largest pole radius
+    double getDecaySamples(double attenuation = 1.0e-6) const noexcept
+    {
+        if (isIdentity())
+            return 0.0;
+
+        const auto discriminant = a1 * a1 - 4.0 * a2;
+        const auto radius = discriminant < 0.0 ? std::sqrt(a2) : 0.5 * (std::abs(a1) + std::sqrt(discriminant));
+
+        if (radius <= 0.0)
+            return 2.0;
+
+        jassert(radius < 1.0);
+        return 2.0 + std::log(attenuation) / std::log(juce::jmin(radius, 0.999999));
+    }
+};
+
+// Same designs as juce::dsp::IIR::Coefficients::make*, minus the heap allocation.
+namespace BiquadDesign
+{
+    inline BiquadCoefficients normalise(double b0, double b1, double b2, double a0, double a1, double a2) noexcept
+    {
+        const auto a0Inv = 1.0 / a0;
+        return { b0 * a0Inv, b1 * a0Inv, b2 * a0Inv, a1 * a0Inv, a2 * a0Inv };
+    }
+
+    inline BiquadCoefficients makePeakFilter(double sampleRate, double frequency, double Q, double gainFactor) noexcept
+    {
+        const auto A = std::sqrt(juce::jmax(gainFactor, 1.0e-6));
+        const auto omega = juce::MathConstants<double>::twoPi * frequency / sampleRate;
+        const auto alpha = std::sin(omega) / (Q * 2.0);
+        const auto c2 = -2.0 * std::cos(omega);
+        const auto alphaTimesA = alpha * A;
+        const auto alphaOverA = alpha / A;
+
+        return normalise(1.0 + alphaTimesA, c2, 1.0 - alphaTimesA, 1.0 + alphaOverA, c2, 1.0 - alphaOverA);
+    }
+
+    // Constant 0 dB peak gain
+    inline BiquadCoefficients makeBandPass(double sampleRate, double frequency, double Q) noexcept
+    {
+        const auto omega = juce::MathConstants<double>::twoPi * frequency / sampleRate;
+        const auto alpha = std::sin(omega) / (Q * 2.0);
+        const auto c2 = -2.0 * std::cos(omega);
+
+        return normalise(alpha, 0.0, -alpha, 1.0 + alpha, c2, 1.0 - alpha);
+    }
+
+    inline BiquadCoefficients makeLowShelf(double sampleRate, double frequency, double Q, double gainFactor) noexcept
+    {
+        const auto A = std::sqrt(juce::jmax(gainFactor, 1.0e-6));
+        const auto aminus1 = A - 1.0;
+        const auto aplus1 = A + 1.0;
+        const auto omega = juce::MathConstants<double>::twoPi * frequency / sampleRate;
+        const auto coso = std::cos(omega);
+        const auto beta = std::sin(omega) * std::sqrt(A) / Q;
+        const auto aminus1TimesCoso = aminus1 * coso;
+
+        return normalise(A * (aplus1 - aminus1TimesCoso + beta),
+            A * 2.0 * (aminus1 - aplus1 * coso),
+            A * (aplus1 - aminus1TimesCoso - beta),
+            aplus1 + aminus1TimesCoso + beta,
+            -2.0 * (aminus1 + aplus1 * coso),
+            aplus1 + aminus1TimesCoso - beta);
+    }
+
+    inline BiquadCoefficients makeHighShelf(double sampleRate, double frequency, double Q, double gainFactor) noexcept
+    {
+        const auto A = std::sqrt(juce::jmax(gainFactor, 1.0e-6));
+        const auto aminus1 = A - 1.0;
+        const auto aplus1 = A + 1.0;
+        const auto omega = juce::MathConstants<double>::twoPi * frequency / sampleRate;
+        const auto coso = std::cos(omega);
+        const auto beta = std::sin(omega) * std::sqrt(A) / Q;
+        const auto aminus1TimesCoso = aminus1 * coso;
+
+        return normalise(A * (aplus1 + aminus1TimesCoso + beta),
+            A * -2.0 * (aminus1 + aplus1 * coso),
+            A * (aplus1 + aminus1TimesCoso - beta),
+            aplus1 - aminus1TimesCoso + beta,
+            2.0 * (aminus1 - aplus1 * coso),
+            aplus1 - aminus1TimesCoso - beta);
+    }
+}
@@ -0,0 +1,184 @@
+#pragma once
+#include <JuceHeader.h>
+#include <cmath>
+#include "BiquadCoefficients.h"
+
+// The per-sample structures BiquadCascade can run a section with. Both take the same BiquadCoefficients,
+// keep two state registers per lane and ramp their coefficients linearly, so they are interchangeable.
+
+// Transposed direct form II: the cheapest structure, and exact enough in double precision.
+// In float its a1/a2 can't resolve poles that sit very close to z = 1, i.e. low bands at high sample rates.
+template <typename SampleType>
+struct TransposedDirectFormII
+{
+    using Vec = juce::dsp::SIMDRegister<SampleType>;
+
+    struct Coefficients
+    {
+        Vec b0, b1, b2, a1, a2;
+
+        void setAll(const BiquadCoefficients& c) noexcept
+        {
+            b0 = Vec::expand(static_cast<SampleType>(c.b0));
+            b1 = Vec::expand(static_cast<SampleType>(c.b1));
+            b2 = Vec::expand(static_cast<SampleType>(c.b2));
+            a1 = Vec::expand(static_cast<SampleType>(c.a1));
+            a2 = Vec::expand(static_cast<SampleType>(c.a2));
+        }
+
+        void setLane(size_t lane, const BiquadCoefficients& c) noexcept
+        {
+            b0.set(lane, static_cast<SampleType>(c.b0));
+            b1.set(lane, static_cast<SampleType>(c.b1));
+            b2.set(lane, static_cast<SampleType>(c.b2));
+            a1.set(lane, static_cast<SampleType>(c.a1));
+            a2.set(lane, static_cast<SampleType>(c.a2));
+        }
+
+        // Any point on the line between two stable sections is stable, since the a1/a2 stability triangle is convex
+        void setStep(const Coefficients& from, const Coefficients& to, SampleType scale) noexcept
+        {
+            b0 = (to.b0 - from.b0) * scale;
+            b1 = (to.b1 - from.b1) * scale;
+            b2 = (to.b2 - from.b2) * scale;
+            a1 = (to.a1 - from.a1) * scale;
+            a2 = (to.a2 - from.a2) * scale;
+        }
+
+        void advance(const Coefficients& step) noexcept
+        {
+            b0 += step.b0;
+            b1 += step.b1;
+            b2 += step.b2;
+            a1 += step.a1;
+            a2 += step.a2;
+        }
+    };
+
+    static Vec tick(const Coefficients& c, Vec& s1, Vec& s2, Vec x) noexcept
+    {
+        const auto y = c.b0 * x + s1;
+        s1 = c.b1 * x - c.a1 * y + s2;
+        s2 = c.b2 * x - c.a2 * y;
+        return y;
+    }
+
+    // A flat section still rings out whatever is left in its state (the poles are only cancelled at the
+    // output), so it can only be dropped once that has died away. It then restarts from the same silence.
+    static bool canSkipFlat(const Vec& s1, const Vec& s2) noexcept
+    {
+        constexpr auto threshold = static_cast<SampleType>(1.0e-8);
+        for (size_t lane = 0; lane < Vec::SIMDNumElements; ++lane)
+            if (std::abs(s1.get(lane)) > threshold || std::abs(s2.get(lane)) > threshold)
+                return false;
+
+        return true;
+    }
+};
+
+// Trapezoidal state-variable filter (Simper's form), reproducing the same response as the biquad it is set from.
+// Its states hold band-pass and low-pass signals instead of partial sums, so a 40 Hz section at 192 kHz
+// keeps its precision in float. It costs a few more operations per sample than TDF II.
+template <typename SampleType>
+struct StateVariableFilter
+{
+    using Vec = juce::dsp::SIMDRegister<SampleType>;
+
+    struct Coefficients
+    {
+        // g and k are what gets ramped; a1..a3 are derived from them after every step
+        Vec g, k, m0, m1, m2;
+        Vec a1, a2, a3;
+
+        void setAll(const BiquadCoefficients& c) noexcept
+        {
+            const auto s = fromBiquad(c);
+            g = Vec::expand(s.g);
+            k = Vec::expand(s.k);
+            m0 = Vec::expand(s.m0);
+            m1 = Vec::expand(s.m1);
+            m2 = Vec::expand(s.m2);
+            updateDerived();
+        }
+
+        void setLane(size_t lane, const BiquadCoefficients& c) noexcept
+        {
+            const auto s = fromBiquad(c);
+            g.set(lane, s.g);
+            k.set(lane, s.k);
+            m0.set(lane, s.m0);
+            m1.set(lane, s.m1);
+            m2.set(lane, s.m2);
+            updateDerived();
+        }
+
+        // g and k stay positive along the whole ramp, so every intermediate section is stable
+        void setStep(const Coefficients& from, const Coefficients& to, SampleType scale) noexcept
+        {
+            g = (to.g - from.g) * scale;
+            k = (to.k - from.k) * scale;
+            m0 = (to.m0 - from.m0) * scale;
+            m1 = (to.m1 - from.m1) * scale;
+            m2 = (to.m2 - from.m2) * scale;
+        }
+
+        void advance(const Coefficients& step) noexcept
+        {
+            g += step.g;
+            k += step.k;
+            m0 += step.m0;
+            m1 += step.m1;
+            m2 += step.m2;
+            updateDerived();
+        }
+
+    private:
+        struct Scalar { SampleType g, k, m0, m1, m2; };
+
+        // Matches the bilinear-transformed SVF denominator and numerator to the biquad's at z = 1, z = -1 and
+        // the odd part. Valid for any section with both poles inside the unit circle, which is all this EQ designs.
+        static Scalar fromBiquad(const BiquadCoefficients& c) noexcept
+        {
+            const auto atDc = 1.0 + c.a1 + c.a2;
+            const auto atNyquist = 1.0 - c.a1 + c.a2;
+            jassert(atDc > 0.0 && atNyquist > 0.0);
+
+            const auto g = std::sqrt(atDc / atNyquist);
+            const auto k = 2.0 * (1.0 - c.a2) / (atNyquist * g);
+            const auto m0 = (c.b0 - c.b1 + c.b2) / atNyquist;
+            const auto m1 = 2.0 * (c.b0 - c.b2) / (atNyquist * g) - m0 * k;
+            const auto m2 = (c.b0 + c.b1 + c.b2) / atDc - m0;
+
+            return { static_cast<SampleType>(g), static_cast<SampleType>(k),
+                static_cast<SampleType>(m0), static_cast<SampleType>(m1), static_cast<SampleType>(m2) };
+        }
+
+        // SIMDRegister has no divide, so the one reciprocal is taken lane by lane
+        void updateDerived() noexcept
+        {
+            for (size_t lane = 0; lane < Vec::SIMDNumElements; ++lane)
+            {
+                const auto gl = g.get(lane);
+                const auto a1l = SampleType(1) / (SampleType(1) + gl * (gl + k.get(lane)));
+                a1.set(lane, a1l);
+                a2.set(lane, gl * a1l);
+                a3.set(lane, gl * gl * a1l);
+            }
+        }
+    };
+
+    // s1 and s2 are the two integrator states (ic1eq, ic2eq)
+    static Vec tick(const Coefficients& c, Vec& s1, Vec& s2, Vec x) noexcept
+    {
+        const auto v3 = x - s2;
+        const auto v1 = c.a1 * s1 + c.a2 * v3;
+        const auto v2 = s2 + c.a2 * s1 + c.a3 * v3;
+        s1 = v1 + v1 - s1;
+        s2 = v2 + v2 - s2;
+        return c.m0 * x + c.m1 * v1 + c.m2 * v2;
+    }
+
+    // A flat section comes out as exactly m0 = 1, m1 = m2 = 0, so its output never depends on the
+    // integrators. They restart from zero when the section comes back, behind the ramp of m1 and m2.
+    static bool canSkipFlat(const Vec&, const Vec&) noexcept { return true; }
+};
@@ -0,0 +1,92 @@
+#include "CoefficientBank.h"
+
+float CoefficientBank::getFrequency(int band, int freqIndex) noexcept
+{
+    freqIndex = juce::jlimit(0, EqTables::numFreqs - 1, freqIndex);
+    return band == lowBand || band == lowMidBand ? EqTables::lowFreqValues[freqIndex]
+                                                 : EqTables::highFreqValues[freqIndex];
+}
+
+BiquadCoefficients CoefficientBank::getInterpolated(int band, int freqIndex, float gainDb, bool shelf, bool proportionalQ) const noexcept
+{
+    gainDb = juce::jlimit(EqTables::gainDbValues[0], EqTables::gainDbValues[EqTables::numGains - 1], gainDb);
+
+    int lower = 0;
+    while (lower < EqTables::numGains - 2 && EqTables::gainDbValues[lower + 1] <= gainDb)
+        ++lower;
+
+    const auto& a = get(band, freqIndex, lower, shelf, proportionalQ);
+    const auto& b = get(band, freqIndex, lower + 1, shelf, proportionalQ);
+    const auto t = static_cast<double>((gainDb - EqTables::gainDbValues[lower]) / (EqTables::gainDbValues[lower + 1] - EqTables::gainDbValues[lower]));
+
+    return { a.b0 + t * (b.b0 - a.b0), a.b1 + t * (b.b1 - a.b1), a.b2 + t * (b.b2 - a.b2),
+        a.a1 + t * (b.a1 - a.a1), a.a2 + t * (b.a2 - a.a2) };
+}
+
+BiquadCoefficients CoefficientBank::design(double rate, int band, double freqHz, float gainDb, bool shelf, bool proportionalQ) noexcept
+{
+    const auto gainFactor = static_cast<double>(juce::Decibels::decibelsToGain(gainDb));
+    const auto Q = static_cast<double>(proportionalQ ? EqTables::getProportionalQ(gainDb) : EqTables::fixedQ);
+
+    // The mid bands have no shelf, a shelf request gives the peak
+    if (shelf && band == lowBand)
+        return BiquadDesign::makeLowShelf(rate, freqHz, Q, gainFactor);
+    if (shelf && band == highBand)
+        return BiquadDesign::makeHighShelf(rate, freqHz * EqTables::highShelfFreqScale, Q, gainFactor);
+
+    return BiquadDesign::makePeakFilter(rate, freqHz, Q, gainFactor);
+}
+
+BiquadCoefficients CoefficientBank::designCut(double rate, int band, double freqHz, int cutLevelIndex) noexcept
+{
+    constexpr auto cutQ = 0.707;
+    cutLevelIndex = juce::jlimit(0, EqTables::numCutLevels - 1, cutLevelIndex);
+    const auto sectionGain = static_cast<double>(juce::Decibels::decibelsToGain(EqTables::cutDbValues[cutLevelIndex] / static_cast<float>(numCutSections)));
+
+    if (band == lowBand)
+        return BiquadDesign::makeLowShelf(rate, freqHz, cutQ, sectionGain);
+    if (band == highBand)
+        return BiquadDesign::makeHighShelf(rate, freqHz, cutQ, sectionGain);
+
+    return BiquadDesign::makePeakFilter(rate, freqHz, cutQ, sectionGain);
+}
+
+BiquadCoefficients CoefficientBank::design(int band, const BandSettings& settings, const ContinuousBand& values, bool proportionalQ) const noexcept
+{
+    if (settings.bypass)
+        return {};
+
+    const auto freqHz = juce::jlimit(getMinFrequency(band), getMaxFrequency(band), values.freqHz);
+    const auto gainDb = settings.mute ? 0.0f : juce::jlimit(EqTables::minContinuousGainDb, EqTables::maxContinuousGainDb, values.gainDb);
+    return design(sampleRate, band, freqHz, gainDb, settings.shelf, proportionalQ);
+}
+
+void CoefficientBank::prepare(double newSampleRate)
+{
+    if (newSampleRate == sampleRate)
+        return;
+
+    sampleRate = newSampleRate;
+    entries.resize(static_cast<size_t>(numBands * EqTables::numFreqs * EqTables::numGains * 2 * 2));
+    cuts.resize(static_cast<size_t>(numBands * EqTables::numFreqs * EqTables::numCutLevels));
+
+    for (int band = 0; band < numBands; ++band)
+    {
+        for (int f = 0; f < EqTables::numFreqs; ++f)
+        {
+            const auto freq = static_cast<double>(getFrequency(band, f));
+            for (int c = 0; c < EqTables::numCutLevels; ++c)
+                cuts[static_cast<size_t>((band * EqTables::numFreqs + f) * EqTables::numCutLevels + c)] = designCut(sampleRate, band, freq, c);
+
+            for (int g = 0; g < EqTables::numGains; ++g)
+            {
+                for (int propQ = 0; propQ < 2; ++propQ)
+                {
+                    for (int shelf = 0; shelf < 2; ++shelf)
+                        entries[static_cast<size_t>(getIndex(band, f, g, shelf != 0, propQ != 0))]
+                            = design(sampleRate, band, freq, EqTables::gainDbValues[g], shelf != 0, propQ != 0);
+                }
+            }
+        }
+    }
+}
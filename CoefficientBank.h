@@ -0,0 +1,134 @@
+#pragma once
+#include <JuceHeader.h>
+#include <array>
+#include <vector>
+#include "BiquadCoefficients.h"
+
+namespace EqTables
+{
+    inline constexpr float lowFreqValues[] = { 40.f, 75.f, 150.f, 300.f, 600.f, 1200.f, 2400.f };
+    inline constexpr float highFreqValues[] = { 800.f, 1500.f, 3000.f, 5000.f, 7000.f, 10000.f, 12500.f };
+    inline constexpr float gainDbValues[] = { -12.f, -9.f, -6.f, -3.f, 0.f, 3.f, 6.f, 9.f, 12.f };
+
+    inline constexpr float cutDbValues[] = { -6.f, -12.f, -18.f, -24.f, -36.f, -48.f }; // Depth of a muted band
+
+    inline constexpr int numFreqs = static_cast<int>(std::size(lowFreqValues));
+    inline constexpr int numGains = static_cast<int>(std::size(gainDbValues));
+    inline constexpr int unityGainIndex = 4;
+    inline constexpr int numCutLevels = static_cast<int>(std::size(cutDbValues));
+    inline constexpr int defaultCutLevelIndex = 3;
+
+    // Continuous mode covers the same span as the steps, with the steps' defaults (300, 600, 3k and 5k Hz)
+    inline constexpr float minContinuousGainDb = gainDbValues[0], maxContinuousGainDb = gainDbValues[numGains - 1];
+    inline constexpr float continuousDefaultFreqs[] = { lowFreqValues[3], lowFreqValues[4], highFreqValues[2], highFreqValues[3] };
+
+    inline constexpr float fixedQ = 1.5f;
+    inline constexpr float highShelfFreqScale = 1.3f;
+
+    inline float getProportionalQ(float gainDb) noexcept
+    {
+        return juce::jlimit(0.7f, 2.2f, 1.0f + 0.2f * std::abs(gainDb));
+    }
+}
+
+// Choice indices of one band, exactly as they come out of the parameters.
+struct BandSettings
+{
+    int freqIndex = 0;
+    int gainIndex = EqTables::unityGainIndex;
+    bool shelf = false, mute = false, bypass = false;
+
+    bool operator==(const BandSettings& other) const noexcept
+    {
+        return freqIndex == other.freqIndex && gainIndex == other.gainIndex
+            && shelf == other.shelf && mute == other.mute && bypass == other.bypass;
+    }
+
+    bool operator!=(const BandSettings& other) const noexcept { return !operator==(other); }
+};
+
+// Frequency and gain of one band in continuous mode; shelf, mute and bypass still come from BandSettings.
+struct ContinuousBand
+{
+    float freqHz = 1000.0f, gainDb = 0.0f;
+
+    bool operator==(const ContinuousBand& other) const noexcept { return freqHz == other.freqHz && gainDb == other.gainDb; }
+    bool operator!=(const ContinuousBand& other) const noexcept { return !operator==(other); }
+};
+
+// Every parameter of the EQ is discrete, so every section it can ever produce is computed up front
+// for the current sample rate. The audio thread only picks entries out of the table.
+class CoefficientBank
+{
+public:
+    enum Band { lowBand, lowMidBand, highMidBand, highBand, numBands };
+
+    // Evaluates a thousand or so sections, and allocates the first time; not realtime safe.
+    // Nothing is looked up before the first call, so an instance that is never played never pays for it.
+    void prepare(double newSampleRate);
+    double getSampleRate() const noexcept { return sampleRate; }
+
+    const BiquadCoefficients& get(int band, int freqIndex, int gainIndex, bool shelf, bool proportionalQ) const noexcept
+    {
+        return entries[static_cast<size_t>(getIndex(band, freqIndex, gainIndex, shelf, proportionalQ))];
+    }
+
+    // Resolves mute/bypass the same way the band behaves on the audio thread.
+    // A bypassed band is kept out of the signal path entirely, so its section is a plain wire.
+    const BiquadCoefficients& get(int band, const BandSettings& settings, bool proportionalQ) const noexcept
+    {
+        static constexpr BiquadCoefficients identity{};
+
+        if (settings.bypass)
+            return identity;
+
+        return get(band, settings.freqIndex, settings.mute ? EqTables::unityGainIndex : settings.gainIndex,
+            settings.shelf, proportionalQ);
+    }
+
+    // A section between two points of the gain grid, for gains that move continuously (dynamic bands).
+    // Blends the coefficients of the two neighbouring entries; a blend of two stable sections is stable.
+    BiquadCoefficients getInterpolated(int band, int freqIndex, float gainDb, bool shelf, bool proportionalQ) const noexcept;
+
+    // A muted band is cut by two of these in series: a shelving high-pass for the low band, a band cut for
+    // the mids and a shelving low-pass for the high band. Each one contributes half of the cut depth.
+    static constexpr int numCutSections = 2;
+
+    const BiquadCoefficients& getCut(int band, int freqIndex, int cutLevelIndex) const noexcept
+    {
+        freqIndex = juce::jlimit(0, EqTables::numFreqs - 1, freqIndex);
+        cutLevelIndex = juce::jlimit(0, EqTables::numCutLevels - 1, cutLevelIndex);
+        return cuts[static_cast<size_t>((band * EqTables::numFreqs + freqIndex) * EqTables::numCutLevels + cutLevelIndex)];
+    }
+
+    // Continuous mode, designed exactly for the bank's sample rate. Too slow for automation on the audio thread,
+    // which uses ContinuousCoefficientTable, but right for the editor's curve and the linear-phase kernel.
+    BiquadCoefficients design(int band, const BandSettings& settings, const ContinuousBand& values, bool proportionalQ) const noexcept;
+    BiquadCoefficients designCut(int band, float freqHz, int cutLevelIndex) const noexcept
+    {
+        return designCut(sampleRate, band, freqHz, cutLevelIndex);
+    }
+
+    // The designs every entry comes from, shared with the continuous table
+    static BiquadCoefficients design(double sampleRate, int band, double freqHz, float gainDb, bool shelf, bool proportionalQ) noexcept;
+    static BiquadCoefficients designCut(double sampleRate, int band, double freqHz, int cutLevelIndex) noexcept;
+
+    static bool hasShelf(int band) noexcept { return band == lowBand || band == highBand; }
+    static float getFrequency(int band, int freqIndex) noexcept;
+
+    // The span of a band's frequency steps, which continuous mode sweeps
+    static float getMinFrequency(int band) noexcept { return getFrequency(band, 0); }
+    static float getMaxFrequency(int band) noexcept { return getFrequency(band, EqTables::numFreqs - 1); }
+
+private:
+    static int getIndex(int band, int freqIndex, int gainIndex, bool shelf, bool proportionalQ) noexcept
+    {
+        freqIndex = juce::jlimit(0, EqTables::numFreqs - 1, freqIndex);
+        gainIndex = juce::jlimit(0, EqTables::numGains - 1, gainIndex);
+        return (((band * EqTables::numFreqs + freqIndex) * EqTables::numGains + gainIndex) * 2 + (shelf ? 1 : 0)) * 2 + (proportionalQ ? 1 : 0);
+    }
+
+    double sampleRate = 0.0;
+    std::vector<BiquadCoefficients> entries; // [band][freq][gain][shelf][proportionalQ]
+    std::vector<BiquadCoefficients> cuts; // [band][freq][cut level]
+};
@@ -0,0 +1,99 @@
+#include "ContinuousCoefficientTable.h"
+
+namespace
+{
+    constexpr float gainPointsPerDb = static_cast<float>(ContinuousCoefficientTable::numGainPoints - 1)
+        / (EqTables::maxContinuousGainDb - EqTables::minContinuousGainDb);
+
+    BiquadCoefficients blend(const BiquadCoefficients& a, const BiquadCoefficients& b, double t) noexcept
+    {
+        return { a.b0 + t * (b.b0 - a.b0), a.b1 + t * (b.b1 - a.b1), a.b2 + t * (b.b2 - a.b2),
+            a.a1 + t * (b.a1 - a.a1), a.a2 + t * (b.a2 - a.a2) };
+    }
+}
+
+void ContinuousCoefficientTable::prepare(double newSampleRate)
+{
+    if (newSampleRate == sampleRate)
+        return;
+
+    sampleRate = newSampleRate;
+    entries.resize(static_cast<size_t>(numCurves * 2 * numFreqPoints * numGainPoints));
+    cuts.resize(static_cast<size_t>(CoefficientBank::numBands * numFreqPoints * EqTables::numCutLevels));
+
+    for (int span = 0; span < 2; ++span)
+    {
+        const auto band = span == 0 ? CoefficientBank::lowBand : CoefficientBank::highBand;
+        logMinFreq[static_cast<size_t>(span)] = std::log(CoefficientBank::getMinFrequency(band));
+        freqPointsPerLog[static_cast<size_t>(span)] = static_cast<float>(numFreqPoints - 1) / (std::log(CoefficientBank::getMaxFrequency(band)) - logMinFreq[static_cast<size_t>(span)]);
+    }
+
+    // Grid frequency of a band's point; the curves of a span all use the same points
+    auto getPointFrequency = [this](int band, int f) {
+        const auto span = static_cast<size_t>(band < CoefficientBank::highMidBand ? 0 : 1);
+        return std::exp(static_cast<double>(logMinFreq[span]) + static_cast<double>(f) / static_cast<double>(freqPointsPerLog[span]));
+        };
+
+    static constexpr int curveBands[] = { CoefficientBank::lowBand, CoefficientBank::highBand, CoefficientBank::lowBand, CoefficientBank::highBand };
+    auto* entry = entries.data();
+
+    for (int curve = 0; curve < numCurves; ++curve)
+    {
+        const auto band = curveBands[curve];
+        const auto shelf = curve == lowShelf || curve == highShelf;
+
+        for (int propQ = 0; propQ < 2; ++propQ)
+            for (int f = 0; f < numFreqPoints; ++f)
+                for (int g = 0; g < numGainPoints; ++g)
+                    *entry++ = CoefficientBank::design(sampleRate, band, getPointFrequency(band, f),
+                        EqTables::minContinuousGainDb + static_cast<float>(g) / gainPointsPerDb, shelf, propQ != 0);
+    }
+
+    auto* cut = cuts.data();
+
+    for (int band = 0; band < CoefficientBank::numBands; ++band)
+        for (int f = 0; f < numFreqPoints; ++f)
+            for (int c = 0; c < EqTables::numCutLevels; ++c)
+                *cut++ = CoefficientBank::designCut(sampleRate, band, getPointFrequency(band, f), c);
+}
+
+void ContinuousCoefficientTable::locateFrequency(int band, float freqHz, int& index, double& fraction) const noexcept
+{
+    const auto span = static_cast<size_t>(band < CoefficientBank::highMidBand ? 0 : 1);
+    const auto position = juce::jlimit(0.0f, static_cast<float>(numFreqPoints - 1),
+        (std::log(juce::jmax(1.0f, freqHz)) - logMinFreq[span]) * freqPointsPerLog[span]);
+
+    index = juce::jmin(static_cast<int>(position), numFreqPoints - 2);
+    fraction = static_cast<double>(position - static_cast<float>(index));
+}
+
+BiquadCoefficients ContinuousCoefficientTable::get(int band, float freqHz, float gainDb, bool shelf, bool proportionalQ) const noexcept
+{
+    jassert(!entries.empty()); // prepare() first
+
+    int f = 0;
+    double tf = 0.0;
+    locateFrequency(band, freqHz, f, tf);
+
+    const auto gainPosition = juce::jlimit(0.0f, static_cast<float>(numGainPoints - 1), (gainDb - EqTables::minContinuousGainDb) * gainPointsPerDb);
+    const auto g = juce::jmin(static_cast<int>(gainPosition), numGainPoints - 2);
+    const auto tg = static_cast<double>(gainPosition - static_cast<float>(g));
+
+    const auto* row = entries.data() + ((static_cast<size_t>(getCurve(band, shelf)) * 2 + (proportionalQ ? 1 : 0)) * numFreqPoints + static_cast<size_t>(f)) * numGainPoints + static_cast<size_t>(g);
+    const auto* nextRow = row + numGainPoints;
+
+    return blend(blend(row[0], row[1], tg), blend(nextRow[0], nextRow[1], tg), tf);
+}
+
+BiquadCoefficients ContinuousCoefficientTable::getCut(int band, float freqHz, int cutLevelIndex) const noexcept
+{
+    jassert(!cuts.empty());
+
+    int f = 0;
+    double tf = 0.0;
+    locateFrequency(band, freqHz, f, tf);
+    cutLevelIndex = juce::jlimit(0, EqTables::numCutLevels - 1, cutLevelIndex);
+
+    const auto* point = cuts.data() + (static_cast<size_t>(band) * numFreqPoints + static_cast<size_t>(f)) * EqTables::numCutLevels + static_cast<size_t>(cutLevelIndex);
+    return blend(point[0], point[EqTables::numCutLevels], tf);
+}
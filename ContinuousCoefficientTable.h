@@ -0,0 +1,57 @@
+#pragma once
+#include <JuceHeader.h>
+#include <array>
+#include <vector>
+#include "CoefficientBank.h"
+
+// Continuous mode on the audio thread. Designing a section takes a handful of trig, pow and sqrt calls, too many for
+// every automation step, so prepare() samples each design on a dense grid, log-spaced in frequency and 0.5 dB apart
+// in gain, and lookups blend the four entries around the requested point. With 64 x 49 points the magnitude stays
+// within 0.05 dB of the exact design at any sample rate (the benchmark's --verify checks this). A blend of stable
+// sections is stable, since the stable (a1, a2) region is a triangle.
+class ContinuousCoefficientTable
+{
+public:
+    static constexpr int numFreqPoints = 64;
+    static constexpr int numGainPoints = 49;
+
+    // Allocates and designs about 25000 sections; not realtime safe
+    void prepare(double newSampleRate);
+    double getSampleRate() const noexcept { return sampleRate; }
+
+    BiquadCoefficients get(int band, float freqHz, float gainDb, bool shelf, bool proportionalQ) const noexcept;
+
+    // Resolves mute and bypass like CoefficientBank::get does
+    BiquadCoefficients get(int band, const BandSettings& settings, const ContinuousBand& values, bool proportionalQ) const noexcept
+    {
+        if (settings.bypass)
+            return {};
+
+        return get(band, values.freqHz, settings.mute ? 0.0f : values.gainDb, settings.shelf, proportionalQ);
+    }
+
+    // Interpolated along frequency only; the depth stays one of the MUTE_CUT steps
+    BiquadCoefficients getCut(int band, float freqHz, int cutLevelIndex) const noexcept;
+
+private:
+    // The low and low-mid bands share a frequency span, as do the high-mid and high bands, and so do their peaks
+    enum Curve { lowPeak, highPeak, lowShelf, highShelf, numCurves };
+
+    static int getCurve(int band, bool shelf) noexcept
+    {
+        if (shelf && band == CoefficientBank::lowBand)
+            return lowShelf;
+        if (shelf && band == CoefficientBank::highBand)
+            return highShelf;
+
+        return band == CoefficientBank::lowBand || band == CoefficientBank::lowMidBand ? lowPeak : highPeak;
+    }
+
+    // Grid position of a frequency, clamped to the band's span; index is the lower neighbour, fraction the blend
+    void locateFrequency(int band, float freqHz, int& index, double& fraction) const noexcept;
+
+    double sampleRate = 0.0;
+    std::array<float, 2> logMinFreq{}, freqPointsPerLog{}; // Per span: low bands, high bands
+    std::vector<BiquadCoefficients> entries; // [curve][proportionalQ][freq][gain]
+    std::vector<BiquadCoefficients> cuts; // [band][freq][cut level]
+};
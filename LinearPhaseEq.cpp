@@ -0,0 +1,316 @@
+#include "LinearPhaseEq.h"
+
+// Shared by every instance in the process. Its threads only start when they're first needed: the loader queue with
+// the first prepare, the design thread when an instance first wants a kernel. The design thread then sleeps until
+// woken, so instances in minimum-phase mode cost it nothing.
+class LinearPhaseEq::Designer : private juce::Thread, private juce::AsyncUpdater
+{
+public:
+    Designer() : juce::Thread("EQ kernel design") {}
+
+    ~Designer() override
+    {
+        cancelPendingUpdate();
+        stopThread(1000);
+        jassert(instances.isEmpty());
+    }
+
+    void add(LinearPhaseEq* eq)
+    {
+        const juce::ScopedLock sl(instancesLock);
+        instances.addIfNotAlreadyThere(eq);
+    }
+
+    // Waits for a design of this instance that is under way
+    void remove(LinearPhaseEq* eq)
+    {
+        const juce::ScopedLock sl(instancesLock);
+        instances.removeFirstMatchingValue(eq);
+    }
+
+    juce::dsp::ConvolutionMessageQueue& getMessageQueue()
+    {
+        const juce::ScopedLock sl(instancesLock);
+        if (messageQueue == nullptr)
+            messageQueue = std::make_unique<juce::dsp::ConvolutionMessageQueue>();
+
+        return *messageQueue;
+    }
+
+    // Not realtime safe
+    void start()
+    {
+        if (!isThreadRunning())
+            startThread();
+    }
+
+    // Realtime safe: a thread that isn't running yet is started from the message thread
+    void wake() noexcept
+    {
+        if (isThreadRunning())
+            notify();
+        else
+            triggerAsyncUpdate();
+    }
+
+private:
+    void handleAsyncUpdate() override { start(); }
+
+    void run() override
+    {
+        while (!threadShouldExit())
+        {
+            {
+                const juce::ScopedLock sl(instancesLock);
+                for (auto* eq : instances)
+                    eq->designRequested();
+            }
+
+            wait(-1); // A wake during the pass leaves the event set, so the next pass follows at once
+        }
+    }
+
+    juce::CriticalSection instancesLock;
+    juce::Array<LinearPhaseEq*> instances;
+    std::unique_ptr<juce::dsp::ConvolutionMessageQueue> messageQueue;
+
+    JUCE_DECLARE_NON_COPYABLE(Designer)
+};
+
+LinearPhaseEq::LinearPhaseEq()
+{
+}
+
+LinearPhaseEq::~LinearPhaseEq()
+{
+    designer->remove(this);
+}
+
+void LinearPhaseEq::prepare(const juce::dsp::ProcessSpec& spec)
+{
+    if (spec.sampleRate == sampleRate && spec.maximumBlockSize == preparedBlockSize && spec.numChannels == preparedChannels)
+        return;
+
+    // Taken before designLock: the design thread holds the designer's lock while it takes an instance's
+    auto& messageQueue = designer->getMessageQueue();
+
+    {
+        const juce::ScopedLock sl(designLock);
+
+        sampleRate = spec.sampleRate;
+        preparedBlockSize = spec.maximumBlockSize;
+        preparedChannels = spec.numChannels;
+        bank.prepare(sampleRate);
+
+        kernelOrder = juce::jmax(8, static_cast<int>(std::ceil(std::log2(sampleRate * kernelSeconds))));
+        kernelLength = 1 << kernelOrder;
+        fft = std::make_unique<juce::dsp::FFT>(kernelOrder);
+        fftData.assign(static_cast<size_t>(2 * kernelLength), 0.0f);
+        kernelValid = false;
+
+        // Rebuilt for the channel count; the stream isn't running, so the audio thread can't be looking
+        const auto numPairs = (spec.numChannels + 1) / 2;
+        convolutions.clear();
+
+        for (juce::uint32 pair = 0; pair < numPairs; ++pair)
+        {
+            auto& convolution = convolutions.emplace_back(std::make_unique<juce::dsp::Convolution>(messageQueue));
+            convolution->prepare({ spec.sampleRate, spec.maximumBlockSize, juce::jmin(2u, spec.numChannels - 2 * pair) });
+        }
+    }
+
+    designer->add(this);
+}
+
+void LinearPhaseEq::setSettings(const ParameterSnapshot& settings) noexcept
+{
+    requestedContinuous.store(packContinuous(settings), std::memory_order_release);
+    requestedSettings.store(pack(settings), std::memory_order_release);
+
+    if (active.load(std::memory_order_relaxed))
+        designer->wake();
+}
+
+void LinearPhaseEq::setActive(bool shouldBeActive) noexcept
+{
+    active.store(shouldBeActive, std::memory_order_relaxed);
+
+    if (shouldBeActive)
+        designer->wake();
+}
+
+void LinearPhaseEq::snapToSettings()
+{
+    // Minimum-phase mode has no use for a kernel; switching to linear phase later asks the design thread for one
+    if (!active.load(std::memory_order_relaxed))
+        return;
+
+    designer->start();
+    designKernel(requestedSettings.load(std::memory_order_acquire), requestedContinuous.load(std::memory_order_acquire));
+
+    // A load is otherwise built on the queue's thread and crossfaded in blocks later, so a render would start through
+    // the previous kernel (or none) while already trimmed by the full latency. Preparing runs the queued load here.
+    const juce::ScopedLock sl(designLock);
+
+    for (size_t pair = 0; pair < convolutions.size(); ++pair)
+        convolutions[pair]->prepare({ sampleRate, preparedBlockSize, juce::jmin(2u, preparedChannels - 2 * static_cast<juce::uint32>(pair)) });
+}
+
+void LinearPhaseEq::process(float* const* channels, size_t numChannels, size_t numSamples) noexcept
+{
+    for (size_t first = 0, pair = 0; first < numChannels && pair < convolutions.size(); first += 2, ++pair)
+    {
+        juce::dsp::AudioBlock<float> block(channels + first, juce::jmin(size_t(2), numChannels - first), numSamples);
+        convolutions[pair]->process(juce::dsp::ProcessContextReplacing<float>(block));
+    }
+}
+
+void LinearPhaseEq::designRequested()
+{
+    if (active.load(std::memory_order_relaxed))
+        designKernel(requestedSettings.load(std::memory_order_acquire), requestedContinuous.load(std::memory_order_acquire));
+}
+
+void LinearPhaseEq::designKernel(juce::uint64 packedSettings, juce::uint64 packedContinuous)
+{
+    const juce::ScopedLock sl(designLock);
+
+    if (fft == nullptr || (kernelValid && packedSettings == designedSettings && packedContinuous == designedContinuous))
+        return;
+
+    const auto settings = unpack(packedSettings, packedContinuous);
+
+    // Composite magnitude of every section the minimum-phase path would run, on the FFT grid.
+    // The (-1)^k term delays it by half a kernel, so the impulse sits in the middle and is symmetric.
+    for (int k = 0; k <= kernelLength / 2; ++k)
+    {
+        const auto frequency = sampleRate * static_cast<double>(k) / static_cast<double>(kernelLength);
+        auto magnitude = 1.0;
+
+        for (int band = 0; band < CoefficientBank::numBands; ++band)
+        {
+            const auto& bandSettings = settings.bands[static_cast<size_t>(band)];
+            const auto& values = settings.continuousBands[static_cast<size_t>(band)];
+            const auto section = settings.continuous ? bank.design(band, bandSettings, values, settings.proportionalQ)
+                                                     : bank.get(band, bandSettings, settings.proportionalQ);
+
+            if (!section.isIdentity())
+                magnitude *= section.getMagnitudeForFrequency(frequency, sampleRate);
+
+            if (bandSettings.mute && !bandSettings.bypass)
+            {
+                const auto cut = settings.continuous ? bank.designCut(band, values.freqHz, settings.cutLevelIndex)
+                                                     : bank.getCut(band, bandSettings.freqIndex, settings.cutLevelIndex);
+                magnitude *= std::pow(cut.getMagnitudeForFrequency(frequency, sampleRate), static_cast<double>(CoefficientBank::numCutSections));
+            }
+        }
+
+        const auto value = static_cast<float>((k & 1) != 0 ? -magnitude : magnitude);
+        fftData[static_cast<size_t>(2 * k)] = value;
+        fftData[static_cast<size_t>(2 * k + 1)] = 0.0f;
+
+        // Mirror into the upper half, so the transform sees a real, even spectrum whatever it reads
+        if (k > 0 && k < kernelLength / 2)
+        {
+            fftData[static_cast<size_t>(2 * (kernelLength - k))] = value;
+            fftData[static_cast<size_t>(2 * (kernelLength - k) + 1)] = 0.0f;
+        }
+    }
+
+    fft->performRealOnlyInverseTransform(fftData.data());
+
+    // Blackman window centred on the peak, to keep the truncated response from rippling
+    juce::AudioBuffer<float> kernel(1, kernelLength);
+    auto* dest = kernel.getWritePointer(0);
+    const auto phaseStep = juce::MathConstants<double>::twoPi / static_cast<double>(kernelLength);
+
+    for (int n = 0; n < kernelLength; ++n)
+    {
+        const auto w = 0.42 - 0.5 * std::cos(phaseStep * n) + 0.08 * std::cos(2.0 * phaseStep * n);
+        dest[n] = static_cast<float>(w) * fftData[static_cast<size_t>(n)];
+    }
+
+    // Convolution prepares the new engine on its own thread and crossfades into it on the audio thread
+    for (auto& convolution : convolutions)
+        convolution->loadImpulseResponse(juce::AudioBuffer<float>(kernel), sampleRate, juce::dsp::Convolution::Stereo::no,
+            juce::dsp::Convolution::Trim::no, juce::dsp::Convolution::Normalise::no);
+
+    designedSettings = packedSettings;
+    designedContinuous = packedContinuous;
+    kernelValid = true;
+}
+
+juce::uint64 LinearPhaseEq::pack(const ParameterSnapshot& settings) noexcept
+{
+    // Ten bits per band: frequency (3), gain (4), shelf, mute, bypass
+    juce::uint64 packed = 0;
+
+    for (int band = 0; band < CoefficientBank::numBands; ++band)
+    {
+        const auto& b = settings.bands[static_cast<size_t>(band)];
+        const auto bits = static_cast<juce::uint64>(b.freqIndex & 7) | (static_cast<juce::uint64>(b.gainIndex & 15) << 3)
+            | (b.shelf ? 1u << 7 : 0u) | (b.mute ? 1u << 8 : 0u) | (b.bypass ? 1u << 9 : 0u);
+        packed |= bits << (10 * band);
+    }
+
+    packed |= static_cast<juce::uint64>(settings.proportionalQ ? 1 : 0) << 40;
+    packed |= static_cast<juce::uint64>(settings.cutLevelIndex & 7) << 41;
+    packed |= static_cast<juce::uint64>(settings.continuous ? 1 : 0) << 44;
+    return packed;
+}
+
+namespace
+{
+    // Continuous values are quantised to 9 bits of log frequency across the band's span and 7 bits of gain:
+    // steps of under 1 % and 0.2 dB, finer than the kernel resolves
+    constexpr int freqSteps = 511, gainSteps = 127;
+
+    double getLogSpan(int band) noexcept
+    {
+        return std::log(static_cast<double>(CoefficientBank::getMaxFrequency(band)) / CoefficientBank::getMinFrequency(band));
+    }
+}
+
+juce::uint64 LinearPhaseEq::packContinuous(const ParameterSnapshot& settings) noexcept
+{
+    // Sixteen bits per band: frequency (9), gain (7)
+    juce::uint64 packed = 0;
+
+    for (int band = 0; band < CoefficientBank::numBands; ++band)
+    {
+        const auto& values = settings.continuousBands[static_cast<size_t>(band)];
+        const auto freq = juce::jlimit(0, freqSteps, juce::roundToInt(std::log(values.freqHz / CoefficientBank::getMinFrequency(band)) / getLogSpan(band) * freqSteps));
+        const auto gain = juce::jlimit(0, gainSteps, juce::roundToInt((values.gainDb - EqTables::minContinuousGainDb)
+            / (EqTables::maxContinuousGainDb - EqTables::minContinuousGainDb) * gainSteps));
+        packed |= static_cast<juce::uint64>(freq | (gain << 9)) << (16 * band);
+    }
+
+    return packed;
+}
+
+ParameterSnapshot LinearPhaseEq::unpack(juce::uint64 packed, juce::uint64 packedContinuous) noexcept
+{
+    ParameterSnapshot settings;
+
+    for (int band = 0; band < CoefficientBank::numBands; ++band)
+    {
+        const auto bits = static_cast<juce::uint32>(packed >> (10 * band));
+        auto& b = settings.bands[static_cast<size_t>(band)];
+        b.freqIndex = static_cast<int>(bits & 7);
+        b.gainIndex = static_cast<int>((bits >> 3) & 15);
+        b.shelf = (bits & (1u << 7)) != 0;
+        b.mute = (bits & (1u << 8)) != 0;
+        b.bypass = (bits & (1u << 9)) != 0;
+
+        const auto continuousBits = static_cast<int>((packedContinuous >> (16 * band)) & 0xffff);
+        auto& values = settings.continuousBands[static_cast<size_t>(band)];
+        values.freqHz = CoefficientBank::getMinFrequency(band) * static_cast<float>(std::exp(getLogSpan(band) * (continuousBits & freqSteps) / freqSteps));
+        values.gainDb = EqTables::minContinuousGainDb + (EqTables::maxContinuousGainDb - EqTables::minContinuousGainDb)
+            * static_cast<float>(continuousBits >> 9) / gainSteps;
+    }
+
+    settings.proportionalQ = ((packed >> 40) & 1) != 0;
+    settings.cutLevelIndex = static_cast<int>((packed >> 41) & 7);
+    settings.continuous = ((packed >> 44) & 1) != 0;
+    return settings;
+}
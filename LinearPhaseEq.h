@@ -0,0 +1,78 @@
+#pragma once
+#include <JuceHeader.h>
+#include <atomic>
+#include <memory>
+#include <vector>
+#include "CoefficientBank.h"
+#include "ParameterSnapshot.h"
+
+// Linear-phase version of the four bands and the cuts of muted bands. Their composite magnitude is sampled
+// into a symmetric FIR, which juce::dsp::Convolution runs with uniformly partitioned FFTs and crossfades
+// whenever a new kernel is loaded. Convolution only does mono or stereo, so there is one per channel pair.
+// Kernels are designed on a background thread; the audio thread only publishes the settings it wants,
+// so nothing on it allocates. Every instance shares one design thread, which sleeps until an instance in
+// linear-phase mode asks for a kernel, and one convolution loader thread.
+class LinearPhaseEq
+{
+public:
+    LinearPhaseEq();
+    ~LinearPhaseEq();
+
+    // Sizes the kernel for the sample rate; not realtime safe.
+    // Hosts often prepare several times with the same spec while a session loads; those calls do nothing.
+    void prepare(const juce::dsp::ProcessSpec& spec);
+    void reset() noexcept
+    {
+        for (auto& convolution : convolutions)
+            convolution->reset();
+    }
+
+    // Realtime safe: wakes the design thread when the linear-phase path is in use
+    void setSettings(const ParameterSnapshot& settings) noexcept;
+
+    // Kernels are only designed while the linear-phase path is in use
+    void setActive(bool shouldBeActive) noexcept;
+
+    // Designs the kernel for the latest settings and installs it before returning, so the first block after a
+    // (re)start already runs through it; not realtime safe
+    void snapToSettings();
+
+    void process(float* const* channels, size_t numChannels, size_t numSamples) noexcept;
+
+    // The kernel is symmetric, so everything comes out half a kernel late
+    int getLatencyInSamples() const noexcept { return kernelLength / 2 + (convolutions.empty() ? 0 : convolutions.front()->getLatency()); }
+    int getKernelLength() const noexcept { return kernelLength; }
+
+private:
+    static constexpr double kernelSeconds = 1.0 / 6.0; // Enough resolution for a 40 Hz band, rounded up to a power of two
+
+    class Designer;
+    void designRequested();
+    void designKernel(juce::uint64 packedSettings, juce::uint64 packedContinuous);
+
+    // Every setting that shapes the response fits in one lock-free word, and continuous mode's values in a second.
+    // The two are stored separately, so the design thread may see one a pass before the other; it catches up on the next.
+    static juce::uint64 pack(const ParameterSnapshot& settings) noexcept;
+    static juce::uint64 packContinuous(const ParameterSnapshot& settings) noexcept;
+    static ParameterSnapshot unpack(juce::uint64 packed, juce::uint64 packedContinuous) noexcept;
+
+    // Declared before the convolutions, which use its loader queue, so it goes after them
+    juce::SharedResourcePointer<Designer> designer;
+    std::vector<std::unique_ptr<juce::dsp::Convolution>> convolutions;
+    double sampleRate = 0.0;
+    juce::uint32 preparedBlockSize = 0, preparedChannels = 0;
+    int kernelOrder = 0, kernelLength = 0;
+
+    std::atomic<juce::uint64> requestedSettings{ 0 }, requestedContinuous{ 0 };
+    std::atomic<bool> active{ false };
+
+    // Only touched while holding designLock, i.e. by the design thread, prepare or snapToSettings
+    juce::CriticalSection designLock;
+    CoefficientBank bank;
+    std::unique_ptr<juce::dsp::FFT> fft;
+    std::vector<float> fftData;
+    juce::uint64 designedSettings = 0, designedContinuous = 0;
+    bool kernelValid = false;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(LinearPhaseEq)
+};
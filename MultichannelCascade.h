@@ -0,0 +1,105 @@
+#pragma once
+#include <JuceHeader.h>
+#include <array>
+#include "BiquadCascade.h"
+
+// BiquadCascade for any channel count up to maxChannels: channels are packed into groups of one SIMD
+// register (4 floats on SSE, 8 on AVX), so a 7.1.4 stem costs three passes instead of twelve.
+// Groups beyond the channels it was prepared for are never processed, and flat stages are skipped per group.
+template <typename SampleType, size_t numStages, template <typename> class Topology = TransposedDirectFormII, size_t maxChannels = 16>
+class MultichannelCascade
+{
+public:
+    using Group = BiquadCascade<SampleType, numStages, Topology>;
+    static constexpr size_t lanesPerGroup = Group::numLanes;
+    static constexpr size_t maxGroups = (maxChannels + lanesPerGroup - 1) / lanesPerGroup;
+    static constexpr size_t maxNumChannels = maxChannels;
+
+    void prepare(double sampleRate, size_t numChannels, double rampLengthSeconds = 0.02) noexcept
+    {
+        jassert(numChannels <= maxChannels);
+        numGroupsInUse = (juce::jmin(numChannels, maxChannels) + lanesPerGroup - 1) / lanesPerGroup;
+
+        for (auto& group : groups)
+            group.prepare(sampleRate, rampLengthSeconds);
+    }
+
+    void reset() noexcept
+    {
+        for (auto& group : groups)
+            group.reset();
+    }
+
+    // The same section on every channel
+    void setCoefficients(size_t stage, const BiquadCoefficients& c) noexcept
+    {
+        for (auto& group : groups)
+            group.setCoefficients(stage, c);
+    }
+
+    void setTargetCoefficients(size_t stage, const BiquadCoefficients& c) noexcept
+    {
+        for (auto& group : groups)
+            group.setTargetCoefficients(stage, c);
+    }
+
+    void glideToCoefficients(size_t stage, const BiquadCoefficients& c, int numSubBlocks) noexcept
+    {
+        for (size_t g = 0; g < numGroupsInUse; ++g)
+            groups[g].glideToCoefficients(stage, c, numSubBlocks);
+    }
+
+    // A section for one channel only
+    void setCoefficients(size_t stage, size_t channel, const BiquadCoefficients& c) noexcept
+    {
+        jassert(channel < maxChannels);
+        groups[channel / lanesPerGroup].setCoefficients(stage, channel % lanesPerGroup, c);
+    }
+
+    void setTargetCoefficients(size_t stage, size_t channel, const BiquadCoefficients& c) noexcept
+    {
+        jassert(channel < maxChannels);
+        groups[channel / lanesPerGroup].setTargetCoefficients(stage, channel % lanesPerGroup, c);
+    }
+
+    // Channels 0 and 1 always share the first group
+    void setMidSideEncoding(bool shouldEncode) noexcept { groups.front().setMidSideEncoding(shouldEncode); }
+
+    // Only the groups in use ever advance their ramps, so only they count
+    bool isRamping() const noexcept
+    {
+        for (size_t g = 0; g < numGroupsInUse; ++g)
+            if (groups[g].isRamping())
+                return true;
+
+        return false;
+    }
+
+    void snapToTargets() noexcept
+    {
+        for (auto& group : groups)
+            group.snapToTargets();
+    }
+
+    bool hasSubnormalState() const noexcept
+    {
+        for (size_t g = 0; g < numGroupsInUse; ++g)
+            if (groups[g].hasSubnormalState())
+                return true;
+
+        return false;
+    }
+
+    void process(SampleType* const* channels, size_t numChannels, size_t numSamples) noexcept
+    {
+        jassert(numChannels <= numGroupsInUse * lanesPerGroup);
+        numChannels = juce::jmin(numChannels, numGroupsInUse * lanesPerGroup);
+
+        for (size_t first = 0, g = 0; first < numChannels; first += lanesPerGroup, ++g)
+            groups[g].process(channels + first, juce::jmin(lanesPerGroup, numChannels - first), numSamples);
+    }
+
+private:
+    std::array<Group, maxGroups> groups;
+    size_t numGroupsInUse = maxGroups;
+};
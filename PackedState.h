@@ -0,0 +1,143 @@
+#pragma once
+#include <JuceHeader.h>
+#include <array>
+#include <cstddef>
+#include <cstring>
+#include <iterator>
+#include "CoefficientBank.h"
+#include "ParameterSnapshot.h"
+
+// The whole plugin state as choice indices plus the dynamics, stereo and continuous settings, in 140 bytes. Snapshot slots, factory
+// programs and the binary session format are all built from it, so recalling a state never goes through strings or a
+// ValueTree. Each session version appended a section (see PackedStateSections), so new fields only ever go at the end.
+struct PackedState
+{
+    enum BandFlags : juce::uint8 { shelf = 1, mute = 2, bypass = 4, dynamic = 8 };
+
+    struct Band
+    {
+        juce::uint8 freqIndex = 0, gainIndex = EqTables::unityGainIndex, flags = 0;
+    };
+
+    std::array<Band, CoefficientBank::numBands> bands{};
+    juce::uint8 proportionalQ = 0, cutLevelIndex = EqTables::defaultCutLevelIndex, oversamplingIndex = 0, linearPhase = 0;
+    float drive = 2.0f;
+
+    struct Dynamics
+    {
+        float thresholdDb = -24.0f, ratio = 4.0f, attackMs = 5.0f, releaseMs = 100.0f;
+    };
+
+    std::array<Dynamics, CoefficientBank::numBands> dynamics{};
+
+    // Right or side channel when the stereo mode is not linked
+    std::array<Band, CoefficientBank::numBands> secondBands{};
+    juce::uint8 stereoMode = 0, reserved[3]{};
+    float secondDrive = 2.0f;
+
+    // Continuous mode's frequency and gain per band, used instead of the first set's indices while it is on
+    struct Continuous
+    {
+        float freqHz, gainDb;
+    };
+
+    std::array<Continuous, CoefficientBank::numBands> continuousBands{ { { EqTables::continuousDefaultFreqs[0], 0.0f },
+        { EqTables::continuousDefaultFreqs[1], 0.0f }, { EqTables::continuousDefaultFreqs[2], 0.0f }, { EqTables::continuousDefaultFreqs[3], 0.0f } } };
+    juce::uint8 continuous = 0, reservedContinuous[3]{};
+
+    static PackedState capture(const ParameterPointers& p) noexcept
+    {
+        auto load = [](const std::atomic<float>* value) { return value != nullptr ? value->load(std::memory_order_relaxed) : 0.0f; };
+        auto index = [&](const std::atomic<float>* value) { return static_cast<juce::uint8>(juce::roundToInt(load(value))); };
+
+        PackedState state;
+
+        for (size_t band = 0; band < state.bands.size(); ++band)
+        {
+            const auto& src = p.bands[band];
+            auto& dst = state.bands[band];
+            dst.freqIndex = index(src.freq);
+            dst.gainIndex = index(src.gain);
+            dst.flags = static_cast<juce::uint8>((load(src.shelf) > 0.5f ? shelf : 0) | (load(src.mute) > 0.5f ? mute : 0)
+                | (load(src.bypass) > 0.5f ? bypass : 0) | (load(src.dynamic) > 0.5f ? dynamic : 0));
+
+            auto& dyn = state.dynamics[band];
+            dyn.thresholdDb = load(src.threshold);
+            dyn.ratio = load(src.ratio);
+            dyn.attackMs = load(src.attack);
+            dyn.releaseMs = load(src.release);
+
+            const auto& secondSrc = p.secondBands[band];
+            auto& secondDst = state.secondBands[band];
+            secondDst.freqIndex = index(secondSrc.freq);
+            secondDst.gainIndex = index(secondSrc.gain);
+            secondDst.flags = static_cast<juce::uint8>((load(secondSrc.shelf) > 0.5f ? shelf : 0) | (load(secondSrc.mute) > 0.5f ? mute : 0)
+                | (load(secondSrc.bypass) > 0.5f ? bypass : 0));
+
+            state.continuousBands[band] = { load(src.continuousFreq), load(src.continuousGain) };
+        }
+
+        state.proportionalQ = index(p.qMode);
+        state.cutLevelIndex = index(p.muteCut);
+        state.oversamplingIndex = index(p.oversampling);
+        state.linearPhase = index(p.phaseMode);
+        state.drive = load(p.drive);
+        state.stereoMode = index(p.stereoMode);
+        state.secondDrive = load(p.secondDrive);
+        state.continuous = index(p.continuous);
+        return state;
+    }
+
+    bool operator==(const PackedState& other) const noexcept { return std::memcmp(this, &other, sizeof(PackedState)) == 0; }
+    bool operator!=(const PackedState& other) const noexcept { return !operator==(other); }
+};
+
+static_assert(sizeof(PackedState) == 140, "PackedState is written to session data as raw bytes");
+static_assert(offsetof(PackedState, dynamics) == 20, "Version 1 sessions hold only what comes before the dynamics");
+static_assert(offsetof(PackedState, secondBands) == 84, "Version 2 sessions hold only what comes before the second band set");
+static_assert(offsetof(PackedState, continuousBands) == 104, "Version 3 sessions hold only what comes before continuous mode");
+
+// Byte ranges of a slot, in the order the session versions added them
+namespace PackedStateSections
+{
+    constexpr size_t ends[] = { offsetof(PackedState, dynamics), offsetof(PackedState, secondBands), offsetof(PackedState, continuousBands), sizeof(PackedState) };
+    constexpr int numSections = static_cast<int>(std::size(ends));
+}
+
+namespace FactoryPrograms
+{
+    struct Program
+    {
+        const char* name;
+        PackedState state;
+    };
+
+    // Band order is low, low-mid, high-mid, high; indices into EqTables
+    inline PackedState makeState(std::array<PackedState::Band, CoefficientBank::numBands> bands, bool proportionalQ, float drive)
+    {
+        PackedState state;
+        state.bands = state.secondBands = bands;
+        state.proportionalQ = proportionalQ ? 1 : 0;
+        state.drive = state.secondDrive = drive;
+
+        // Switching a program to continuous mode starts from where its steps are
+        for (size_t band = 0; band < bands.size(); ++band)
+            state.continuousBands[band] = { CoefficientBank::getFrequency(static_cast<int>(band), bands[band].freqIndex),
+                EqTables::gainDbValues[bands[band].gainIndex] };
+
+        return state;
+    }
+
+    inline const std::array<Program, 5>& getPrograms()
+    {
+        static const std::array<Program, 5> programs{ {
+            { "Flat", makeState({ { { 3, 4, 0 }, { 4, 4, 0 }, { 2, 4, 0 }, { 3, 4, 0 } } }, false, 0.0f) },
+            { "Vocal Presence", makeState({ { { 2, 3, 0 }, { 4, 3, 0 }, { 2, 6, 0 }, { 5, 5, PackedState::shelf } } }, true, 1.5f) },
+            { "Kick Punch", makeState({ { { 1, 7, 0 }, { 3, 2, 0 }, { 1, 6, 0 }, { 3, 4, 0 } } }, false, 3.0f) },
+            { "Air", makeState({ { { 3, 4, 0 }, { 4, 4, 0 }, { 3, 5, 0 }, { 6, 7, PackedState::shelf } } }, true, 1.0f) },
+            { "Mix Bus Glue", makeState({ { { 0, 5, PackedState::shelf }, { 3, 3, 0 }, { 2, 5, 0 }, { 5, 5, PackedState::shelf } } }, true, 2.0f) },
+        } };
+
+        return programs;
+    }
+}
@@ -0,0 +1,94 @@
+#pragma once
+#include <JuceHeader.h>
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+// One parameter change as the host or the editor made it: which parameter (by index), the DSP parts it marks dirty,
+// its plain (not normalised) value and when it arrived, in high-resolution ticks
+struct ParameterEvent
+{
+    int index = 0;
+    juce::uint32 flags = 0;
+    float value = 0.0f;
+    juce::int64 ticks = 0;
+};
+
+// Bounded, lock-free queue from any number of threads to the audio thread. Parameter changes can come from the host's
+// automation thread, the message thread and the audio thread itself, sometimes at once, so pushing is multi-producer:
+// each cell carries a sequence number that says whose turn it is. Popping is audio thread only.
+class ParameterEventQueue
+{
+public:
+    static constexpr size_t capacity = 512;
+    static_assert((capacity & (capacity - 1)) == 0, "The index wraps with a mask");
+
+    ParameterEventQueue() noexcept
+    {
+        for (size_t i = 0; i < capacity; ++i)
+            cells[i].sequence.store(i, std::memory_order_relaxed);
+    }
+
+    // False when full; the caller has to fall back on something that can't overflow
+    bool push(const ParameterEvent& event) noexcept
+    {
+        auto position = tail.load(std::memory_order_relaxed);
+
+        for (;;)
+        {
+            auto& cell = cells[position & mask];
+            const auto sequence = cell.sequence.load(std::memory_order_acquire);
+            const auto difference = static_cast<std::intptr_t>(sequence) - static_cast<std::intptr_t>(position);
+
+            if (difference == 0)
+            {
+                if (tail.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+                {
+                    cell.event = event;
+                    cell.sequence.store(position + 1, std::memory_order_release);
+                    return true;
+                }
+            }
+            else if (difference < 0)
+            {
+                return false; // The consumer hasn't got round to this cell yet
+            }
+            else
+            {
+                position = tail.load(std::memory_order_relaxed); // Another producer took it
+            }
+        }
+    }
+
+    // The consumer marks its thread once per block, so producers can tell when they are running on it
+    void setConsumerThread() noexcept { consumerThread.store(juce::Thread::getCurrentThreadId(), std::memory_order_relaxed); }
+    bool isConsumerThread() const noexcept { return consumerThread.load(std::memory_order_relaxed) == juce::Thread::getCurrentThreadId(); }
+
+    bool pop(ParameterEvent& event) noexcept
+    {
+        auto& cell = cells[head & mask];
+        if (cell.sequence.load(std::memory_order_acquire) != head + 1)
+            return false;
+
+        event = cell.event;
+        cell.sequence.store(head + capacity, std::memory_order_release);
+        ++head;
+        return true;
+    }
+
+private:
+    static constexpr size_t mask = capacity - 1;
+
+    struct Cell
+    {
+        std::atomic<size_t> sequence{ 0 };
+        ParameterEvent event;
+    };
+
+    std::array<Cell, capacity> cells;
+    alignas(64) std::atomic<size_t> tail{ 0 };
+    alignas(64) size_t head = 0;
+    std::atomic<juce::Thread::ThreadID> consumerThread{ nullptr };
+
+    JUCE_DECLARE_NON_COPYABLE(ParameterEventQueue)
+};
@@ -0,0 +1,185 @@
+#include "ParameterLayout.h"
+#include "PluginProcessor.h"
+#include <cmath>
+#include <unordered_map>
+
+std::unique_ptr<juce::RangedAudioParameter> ParameterDescription::create() const
+{
+    switch (type)
+    {
+        case Type::choice:
+            return std::make_unique<juce::AudioParameterChoice>(id, name, choices, juce::roundToInt(defaultValue));
+        case Type::boolean:
+            return std::make_unique<juce::AudioParameterBool>(id, name, defaultValue >= 0.5f);
+        case Type::floating:
+            break;
+    }
+
+    return std::make_unique<juce::AudioParameterFloat>(id, name, range, defaultValue, floatAttributes);
+}
+
+namespace
+{
+    struct Layout
+    {
+        std::vector<ParameterDescription> descriptions;
+        std::unordered_map<juce::uint32, int> indexByHash;
+    };
+
+    Layout buildLayout()
+    {
+        Layout layout;
+        auto& params = layout.descriptions;
+
+        auto addChoice = [&](const juce::String& id, const juce::String& name, const juce::StringArray& choices, int defaultIndex, juce::uint32 flags) {
+            auto& p = params.emplace_back();
+            p.type = ParameterDescription::Type::choice;
+            p.id = id;
+            p.name = name;
+            p.choices = choices;
+            p.defaultValue = static_cast<float>(defaultIndex);
+            p.dirtyFlags = flags;
+            };
+
+        auto addBool = [&](const juce::String& id, const juce::String& name, bool defaultValue, juce::uint32 flags) {
+            auto& p = params.emplace_back();
+            p.type = ParameterDescription::Type::boolean;
+            p.id = id;
+            p.name = name;
+            p.defaultValue = defaultValue ? 1.0f : 0.0f;
+            p.dirtyFlags = flags;
+            };
+
+        auto addFloat = [&](const juce::String& id, const juce::String& name, juce::NormalisableRange<float> range, float defaultValue,
+            juce::uint32 flags, const juce::AudioParameterFloatAttributes& attributes = {}) {
+            auto& p = params.emplace_back();
+            p.type = ParameterDescription::Type::floating;
+            p.id = id;
+            p.name = name;
+            p.range = range;
+            p.floatAttributes = attributes;
+            p.defaultValue = defaultValue;
+            p.dirtyFlags = flags;
+            };
+
+        const juce::StringArray lowFreqChoices{ "40", "75", "150", "300", "600", "1.2k", "2.4k" };
+        const juce::StringArray highFreqChoices{ "800", "1.5k", "3k", "5k", "7k", "10k", "12.5k" };
+        const juce::StringArray gainChoices{ "-12", "-9", "-6", "-3", "0", "3", "6", "9", "12" };
+
+        // Everything a band has marks only that band
+        auto addBand = [&](int band, const juce::String& prefix, const juce::String& name, const juce::StringArray& freqs, int defaultFreqIndex) {
+            addChoice(prefix + "_FREQ", name + " Freq", freqs, defaultFreqIndex, 1u << band);
+            addChoice(prefix + "_GAIN", name + " Gain", gainChoices, 4, 1u << band);
+            addBool(prefix + "_MUTE", name + " Mute", false, 1u << band); // New: Mute, default off (unmuted)
+            addBool(prefix + "_BYPASS", name + " Bypass", false, 1u << band); // New: Bypass, default off (not bypassed)
+            };
+
+        addBand(CoefficientBank::lowBand, "LOW", "Low", lowFreqChoices, 3); // Default 300 Hz
+        addBool(Params::LOW_SHELF, "Low Shelf", false, DirtyFlags::lowBand);
+        addBand(CoefficientBank::lowMidBand, "LM", "Low Mid", lowFreqChoices, 4); // Default 600 Hz
+        addBand(CoefficientBank::highMidBand, "HM", "High Mid", highFreqChoices, 2); // Default 3k Hz
+        addBand(CoefficientBank::highBand, "HIGH", "High", highFreqChoices, 3); // Default 5k Hz
+        addBool(Params::HIGH_SHELF, "High Shelf", false, DirtyFlags::highBand);
+        addFloat(Params::SAT_DRIVE, "Saturation Drive", { 0.0f, 10.0f }, 2.0f, DirtyFlags::saturation); // 0.0 to 10.0
+        addBool(Params::Q_MODE, "Proportional Q", false, DirtyFlags::allBands); // False = Fixed Q
+
+        // The original 21 end here; everything after is appended, so hosts that map parameters by index keep working
+        addChoice(Params::SAT_OVERSAMPLING, "Saturation Oversampling", { "1x", "2x", "4x", "8x" }, 0, DirtyFlags::saturation);
+        addChoice(Params::MUTE_CUT, "Mute Cut Level", { "-6", "-12", "-18", "-24", "-36", "-48" },
+            EqTables::defaultCutLevelIndex, DirtyFlags::allBands); // Must match EqTables::cutDbValues
+        addChoice(Params::PHASE_MODE, "Phase Mode", { "Minimum", "Linear" }, 0, DirtyFlags::phaseMode);
+
+        // Appended after everything else, so the existing parameters keep their indices
+        const std::pair<const char*, const char*> bandNames[] = { { "LOW", "Low" }, { "LM", "Low Mid" }, { "HM", "High Mid" }, { "HIGH", "High" } };
+
+        for (int band = 0; band < CoefficientBank::numBands; ++band)
+        {
+            const juce::String p(bandNames[band].first), n(bandNames[band].second);
+            addBool(p + "_DYN", n + " Dynamic", false, 1u << band);
+            addFloat(p + "_THRESHOLD", n + " Threshold", { -60.0f, 0.0f, 0.1f }, -24.0f, 1u << band);
+            addFloat(p + "_RATIO", n + " Ratio", { 1.0f, 20.0f, 0.01f, 0.4f }, 4.0f, 1u << band);
+            addFloat(p + "_ATTACK", n + " Attack", { 0.1f, 100.0f, 0.01f, 0.4f }, 5.0f, 1u << band); // ms
+            addFloat(p + "_RELEASE", n + " Release", { 5.0f, 1000.0f, 0.1f, 0.4f }, 100.0f, 1u << band); // ms
+        }
+
+        addChoice(Params::STEREO_MODE, "Stereo Mode", { "Linked", "Dual Mono", "Mid/Side" }, 0, DirtyFlags::stereoMode); // Must match StereoMode
+        addFloat(Params::SAT_DRIVE_B, "Saturation Drive (R/S)", { 0.0f, 10.0f }, 2.0f, DirtyFlags::saturation);
+
+        for (int band = 0; band < CoefficientBank::numBands; ++band)
+        {
+            const juce::String p(bandNames[band].first), n(juce::String(bandNames[band].second) + " (R/S)");
+            const auto& freqs = band == CoefficientBank::lowBand || band == CoefficientBank::lowMidBand ? lowFreqChoices : highFreqChoices;
+            const auto defaultFreq = band == CoefficientBank::lowBand ? 3 : band == CoefficientBank::lowMidBand ? 4 : band == CoefficientBank::highMidBand ? 2 : 3; // Same defaults as the first set
+            addChoice(p + "_FREQ_B", n + " Freq", freqs, defaultFreq, 1u << band);
+            addChoice(p + "_GAIN_B", n + " Gain", gainChoices, 4, 1u << band);
+            addBool(p + "_MUTE_B", n + " Mute", false, 1u << band);
+            addBool(p + "_BYPASS_B", n + " Bypass", false, 1u << band);
+            if (CoefficientBank::hasShelf(band))
+                addBool(p + "_SHELF_B", n + " Shelf", false, 1u << band);
+        }
+
+        addBool(Params::CONTINUOUS, "Continuous", false, DirtyFlags::allBands); // False = the 550B's steps
+
+        // Written like the stepped choices, "600" or "1.25k"
+        const auto freqAttributes = juce::AudioParameterFloatAttributes()
+            .withStringFromValueFunction([](float value, int) { return value < 1000.0f ? juce::String(juce::roundToInt(value)) : juce::String(value / 1000.0f, 2) + "k"; })
+            .withValueFromStringFunction([](const juce::String& text) { return text.getFloatValue() * (text.containsIgnoreCase("k") ? 1000.0f : 1.0f); });
+
+        for (int band = 0; band < CoefficientBank::numBands; ++band)
+        {
+            const juce::String p(bandNames[band].first), n(bandNames[band].second);
+            const auto minFreq = CoefficientBank::getMinFrequency(band), maxFreq = CoefficientBank::getMaxFrequency(band);
+            juce::NormalisableRange<float> freqRange(minFreq, maxFreq);
+            freqRange.setSkewForCentre(std::sqrt(minFreq * maxFreq)); // The middle of the knob is the middle of the span in octaves
+
+            addFloat(p + "_FREQ_C", n + " Freq (Continuous)", freqRange, EqTables::continuousDefaultFreqs[band], 1u << band, freqAttributes);
+            addFloat(p + "_GAIN_C", n + " Gain (Continuous)", { EqTables::minContinuousGainDb, EqTables::maxContinuousGainDb, 0.01f }, 0.0f, 1u << band);
+        }
+
+        addBool(Params::AUTO_GAIN, "Auto Gain", false, DirtyFlags::autoGain);
+
+        // Unlinked, the odd channels default to the first set and the even ones to the second, as dual mono splits a pair
+        addBool(Params::CHANNEL_LINK, "Channel Link", true, DirtyFlags::stereoMode);
+        for (size_t ch = 0; ch < Params::CHANNEL_SETS.size(); ++ch)
+            addChoice(Params::CHANNEL_SETS[ch], "Ch " + juce::String(ch + 1) + " Band Set", { "First", "Second" }, static_cast<int>(ch % 2), DirtyFlags::stereoMode);
+
+        for (size_t i = 0; i < params.size(); ++i)
+        {
+            params[i].hash = ParameterLayout::hashID(params[i].id);
+            const auto inserted = layout.indexByHash.emplace(params[i].hash, static_cast<int>(i)).second;
+            jassertquiet(inserted); // Two IDs hash the same; the binary state couldn't tell them apart
+        }
+
+        return layout;
+    }
+
+    const Layout& getLayout()
+    {
+        static const Layout layout = buildLayout();
+        return layout;
+    }
+}
+
+namespace ParameterLayout
+{
+    const std::vector<ParameterDescription>& getDescriptions()
+    {
+        return getLayout().descriptions;
+    }
+
+    int findIndex(juce::uint32 hash) noexcept
+    {
+        const auto& indexByHash = getLayout().indexByHash;
+        const auto it = indexByHash.find(hash);
+        return it != indexByHash.end() ? it->second : -1;
+    }
+
+    juce::uint32 hashID(const juce::String& id) noexcept
+    {
+        juce::uint32 hash = 2166136261u;
+        for (auto* c = id.toRawUTF8(); *c != 0; ++c)
+            hash = (hash ^ static_cast<juce::uint8>(*c)) * 16777619u;
+
+        return hash;
+    }
+}
@@ -0,0 +1,35 @@
+#pragma once
+#include <JuceHeader.h>
+#include <memory>
+#include <vector>
+
+// One host parameter as plain data: everything needed to create it, plus the parts of the DSP it marks dirty
+// (DirtyFlags) and the hash of its ID, which names it in the binary session format.
+struct ParameterDescription
+{
+    enum class Type { choice, boolean, floating };
+
+    Type type = Type::boolean;
+    juce::String id, name;
+    juce::StringArray choices; // Choice parameters only
+    juce::NormalisableRange<float> range; // Float parameters only
+    juce::AudioParameterFloatAttributes floatAttributes;
+    float defaultValue = 0.0f; // The choice's index, 0 or 1, or the float's value
+    juce::uint32 dirtyFlags = 0;
+    juce::uint32 hash = 0;
+
+    std::unique_ptr<juce::RangedAudioParameter> create() const;
+};
+
+// Every parameter of the plugin, in index order. Built on first use and shared, read-only, by every instance, so
+// an instance only has to create its parameter objects; sessions with hundreds of instances pay for the rest once.
+namespace ParameterLayout
+{
+    const std::vector<ParameterDescription>& getDescriptions();
+
+    // The parameter index for a hashed ID, or -1 for a parameter this version doesn't have
+    int findIndex(juce::uint32 hash) noexcept;
+
+    // FNV-1a over the UTF-8 bytes, so the value is the same on every platform and JUCE version
+    juce::uint32 hashID(const juce::String& id) noexcept;
+}
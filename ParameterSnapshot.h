@@ -0,0 +1,200 @@
+#pragma once
+#include <JuceHeader.h>
+#include <array>
+#include <atomic>
+#include <vector>
+#include "CoefficientBank.h"
+#include "ParameterEventQueue.h"
+#include "StereoMode.h"
+
+// What changed since the audio thread last looked, one bit per independently updatable part
+namespace DirtyFlags
+{
+    enum : juce::uint32
+    {
+        lowBand = 1u << CoefficientBank::lowBand,
+        lowMidBand = 1u << CoefficientBank::lowMidBand,
+        highMidBand = 1u << CoefficientBank::highMidBand,
+        highBand = 1u << CoefficientBank::highBand,
+        allBands = lowBand | lowMidBand | highMidBand | highBand,
+        saturation = 1u << 4,
+        phaseMode = 1u << 5,
+        stereoMode = 1u << 6, // Also the channel link and each channel's band set
+        autoGain = 1u << 7,
+        all = allBands | saturation | phaseMode | stereoMode | autoGain
+    };
+}
+
+// The parameter atomics, looked up by ID once at construction so the audio thread never has to
+struct ParameterPointers
+{
+    static constexpr size_t maxChannels = 16; // Api550bAudioProcessor::maxChannels
+
+    struct Band
+    {
+        std::atomic<float>* freq = nullptr;
+        std::atomic<float>* gain = nullptr;
+        std::atomic<float>* shelf = nullptr; // Only the low and high bands have one
+        std::atomic<float>* mute = nullptr;
+        std::atomic<float>* bypass = nullptr;
+        std::atomic<float>* dynamic = nullptr;
+        std::atomic<float>* threshold = nullptr;
+        std::atomic<float>* ratio = nullptr;
+        std::atomic<float>* attack = nullptr;
+        std::atomic<float>* release = nullptr;
+        std::atomic<float>* continuousFreq = nullptr; // Continuous mode; the second set has none
+        std::atomic<float>* continuousGain = nullptr;
+    };
+
+    std::array<Band, CoefficientBank::numBands> bands;
+    std::array<Band, CoefficientBank::numBands> secondBands; // Right or side channel; no dynamics
+    std::atomic<float>* qMode = nullptr;
+    std::atomic<float>* drive = nullptr;
+    std::atomic<float>* oversampling = nullptr;
+    std::atomic<float>* muteCut = nullptr;
+    std::atomic<float>* phaseMode = nullptr;
+    std::atomic<float>* stereoMode = nullptr;
+    std::atomic<float>* secondDrive = nullptr;
+    std::atomic<float>* continuous = nullptr;
+    std::atomic<float>* autoGain = nullptr;
+    std::atomic<float>* channelLink = nullptr;
+    std::array<std::atomic<float>*, maxChannels> channelSets{};
+};
+
+// How a band in dynamic mode follows its envelope; only used while the band is neither muted nor bypassed
+struct DynamicSettings
+{
+    bool enabled = false;
+    float thresholdDb = -24.0f, ratio = 4.0f, attackMs = 5.0f, releaseMs = 100.0f;
+};
+
+// Plain copy of the parameter state used by the DSP, refreshed one dirty part at a time
+struct ParameterSnapshot
+{
+    std::array<BandSettings, CoefficientBank::numBands> bands;
+    std::array<DynamicSettings, CoefficientBank::numBands> dynamics;
+    std::array<BandSettings, CoefficientBank::numBands> secondBands;
+    std::array<ContinuousBand, CoefficientBank::numBands> continuousBands; // Replace the first set's steps in continuous mode
+    bool continuous = false;
+    bool proportionalQ = false;
+    float drive = 2.0f, secondDrive = 2.0f;
+    StereoMode stereoMode = StereoMode::linked;
+    int oversamplingIndex = 0;
+    int cutLevelIndex = EqTables::defaultCutLevelIndex;
+    bool linearPhase = false;
+    bool autoGain = false;
+    bool channelLink = true;
+    juce::uint32 unlinkedSecondSetChannels = 0; // One bit per channel that picks the second set, used while unlinked
+
+    static void readBandSettings(const ParameterPointers::Band& src, BandSettings& dst) noexcept
+    {
+        dst.freqIndex = static_cast<int>(src.freq->load(std::memory_order_relaxed));
+        dst.gainIndex = static_cast<int>(src.gain->load(std::memory_order_relaxed));
+        dst.shelf = src.shelf != nullptr && src.shelf->load(std::memory_order_relaxed) > 0.5f;
+        dst.mute = src.mute->load(std::memory_order_relaxed) > 0.5f;
+        dst.bypass = src.bypass->load(std::memory_order_relaxed) > 0.5f;
+    }
+
+    void readBand(const ParameterPointers& p, int band) noexcept
+    {
+        const auto& src = p.bands[static_cast<size_t>(band)];
+        readBandSettings(src, bands[static_cast<size_t>(band)]);
+        readBandSettings(p.secondBands[static_cast<size_t>(band)], secondBands[static_cast<size_t>(band)]);
+
+        if (src.continuousFreq != nullptr)
+        {
+            auto& values = continuousBands[static_cast<size_t>(band)];
+            values.freqHz = src.continuousFreq->load(std::memory_order_relaxed);
+            values.gainDb = src.continuousGain->load(std::memory_order_relaxed);
+        }
+
+        auto& dyn = dynamics[static_cast<size_t>(band)];
+        dyn.enabled = src.dynamic != nullptr && src.dynamic->load(std::memory_order_relaxed) > 0.5f;
+        if (dyn.enabled)
+        {
+            dyn.thresholdDb = src.threshold->load(std::memory_order_relaxed);
+            dyn.ratio = src.ratio->load(std::memory_order_relaxed);
+            dyn.attackMs = src.attack->load(std::memory_order_relaxed);
+            dyn.releaseMs = src.release->load(std::memory_order_relaxed);
+        }
+    }
+
+    bool isDynamic(int band) const noexcept
+    {
+        const auto& settings = bands[static_cast<size_t>(band)];
+        return dynamics[static_cast<size_t>(band)].enabled && !settings.mute && !settings.bypass;
+    }
+
+    void readGlobals(const ParameterPointers& p) noexcept
+    {
+        proportionalQ = p.qMode->load(std::memory_order_relaxed) > 0.5f;
+        drive = p.drive->load(std::memory_order_relaxed);
+        oversamplingIndex = static_cast<int>(p.oversampling->load(std::memory_order_relaxed));
+        cutLevelIndex = static_cast<int>(p.muteCut->load(std::memory_order_relaxed));
+        linearPhase = p.phaseMode->load(std::memory_order_relaxed) > 0.5f;
+        stereoMode = static_cast<StereoMode>(juce::jlimit(0, 2, static_cast<int>(p.stereoMode->load(std::memory_order_relaxed))));
+        secondDrive = p.secondDrive->load(std::memory_order_relaxed);
+        continuous = p.continuous != nullptr && p.continuous->load(std::memory_order_relaxed) > 0.5f;
+        autoGain = p.autoGain != nullptr && p.autoGain->load(std::memory_order_relaxed) > 0.5f;
+        channelLink = p.channelLink == nullptr || p.channelLink->load(std::memory_order_relaxed) > 0.5f;
+
+        unlinkedSecondSetChannels = 0;
+        for (size_t ch = 0; ch < p.channelSets.size(); ++ch)
+            if (p.channelSets[ch] != nullptr && p.channelSets[ch]->load(std::memory_order_relaxed) > 0.5f)
+                unlinkedSecondSetChannels |= 1u << ch;
+    }
+};
+
+// Added to the processor itself, so one registration hears every parameter; queues each change with its plain value,
+// arrival time and the parts it marks dirty, so the audio thread can apply it at the right sample. When the queue is
+// full the part's dirty bits are set instead, which makes the audio thread re-read all values at the start of its next
+// block. The processor calls its listeners after the parameter's own, APVTS's among them, so that re-read never
+// misses the new value.
+class ParameterChangeListener : public juce::AudioProcessorListener
+{
+public:
+    ParameterChangeListener(ParameterEventQueue& queue, std::atomic<juce::uint32>& overflowFlags)
+        : events(queue), overflow(overflowFlags) {}
+
+    // In parameter index order, before the listener is added to the processor
+    void addParameter(juce::RangedAudioParameter* parameter, juce::uint32 flags)
+    {
+        entries.push_back({ parameter, flags });
+    }
+
+    // A recall hands the audio thread its whole state in one piece, so the changes it makes on its own thread aren't queued
+    void setRecallThread(juce::Thread::ThreadID thread) noexcept { recallThread.store(thread, std::memory_order_relaxed); }
+
+    void audioProcessorParameterChanged(juce::AudioProcessor*, int index, float newValue) override
+    {
+        if (!juce::isPositiveAndBelow(index, static_cast<int>(entries.size())))
+            return;
+
+        if (const auto thread = recallThread.load(std::memory_order_relaxed); thread != nullptr && thread == juce::Thread::getCurrentThreadId())
+            return;
+
+        const auto& entry = entries[static_cast<size_t>(index)];
+        if (entry.parameter == nullptr || entry.flags == 0)
+            return;
+
+        // On the audio thread the change belongs to the start of the coming block, which time 0 always maps to
+        const auto ticks = events.isConsumerThread() ? 0 : juce::Time::getHighResolutionTicks();
+
+        if (!events.push({ index, entry.flags, entry.parameter->convertFrom0to1(newValue), ticks }))
+            overflow.fetch_or(entry.flags, std::memory_order_release);
+    }
+
+    void audioProcessorChanged(juce::AudioProcessor*, const ChangeDetails&) override {}
+
+private:
+    struct Entry
+    {
+        juce::RangedAudioParameter* parameter;
+        juce::uint32 flags;
+    };
+
+    ParameterEventQueue& events;
+    std::atomic<juce::uint32>& overflow;
+    std::vector<Entry> entries; // By parameter index
+    std::atomic<juce::Thread::ThreadID> recallThread{ nullptr };
+};
@@ -1,6 +1,8 @@
 #include "PluginProcessor.h"
 #include "PluginEditor.h"
 #include <cmath>
+#include <map>
+#include <tuple>
 
 // A more modern, detailed LookAndFeel class
 class ApiLookAndFeel : public juce::LookAndFeel_V4
@@ -31,68 +33,91 @@ public:
         auto centre = bounds.getCentre();
         auto toAngle = rotaryStartAngle + sliderPos * (rotaryEndAngle - rotaryStartAngle);
 
-        // Knob Body
-        juce::ColourGradient knobGradient(juce::Colour(0xff444444), centre.getX(), centre.getY(),
-            juce::Colour(0xff222222), centre.getX(), centre.getY() + radius, true);
-        g.setGradientFill(knobGradient);
-        g.fillEllipse(bounds);
+        // Knob body and outline never move, so they come from the cache
+        drawCached(g, bounds, 0, 0, [this](juce::Graphics& ig, juce::Rectangle<float> area) {
+            auto knobRadius = juce::jmin(area.getWidth(), area.getHeight()) / 2.0f;
+            auto knobCentre = area.getCentre();
 
-        // Outline
-        g.setColour(findColour(juce::Slider::rotarySliderOutlineColourId));
-        g.drawEllipse(bounds, 1.5f);
+            // Knob Body
+            juce::ColourGradient knobGradient(juce::Colour(0xff444444), knobCentre.getX(), knobCentre.getY(),
+                juce::Colour(0xff222222), knobCentre.getX(), knobCentre.getY() + knobRadius, true);
+            ig.setGradientFill(knobGradient);
+            ig.fillEllipse(area);
 
-        // Pointer
-        juce::Path p;
+            // Outline
+            ig.setColour(findColour(juce::Slider::rotarySliderOutlineColourId));
+            ig.drawEllipse(area, 1.5f);
+            });
+
+        // Pointer: a small dot near the edge, the only part that is drawn every time
         auto pointerRadius = radius * 0.8f;
-        p.addEllipse(0, -pointerRadius - 2, 4, 4); // A small dot near the edge
-        p.applyTransform(juce::AffineTransform::rotation(toAngle, 0, 0).translated(centre));
+        auto dotCentre = centre + juce::Point<float>(2.0f, -pointerRadius).rotatedAboutOrigin(toAngle);
         g.setColour(findColour(juce::Slider::thumbColourId));
-        g.fillPath(p);
+        g.fillEllipse(juce::Rectangle<float>(4.0f, 4.0f).withCentre(dotCentre));
     }
 
-    // Custom drawing for illuminated toggle buttons
-    void drawToggleButton(juce::Graphics& g, juce::ToggleButton& button, bool /*shouldDrawButtonAsHighlighted*/, bool /*shouldDrawButtonAsDown*/)
+    // The editor's buttons are all TextButtons. Their backgrounds only vary with the colour, the mouse state, focus,
+    // enablement and which edges are joined to a neighbour, so each look is drawn by LookAndFeel_V4 once, then blitted.
+    void drawButtonBackground(juce::Graphics& g, juce::Button& button, const juce::Colour& backgroundColour,
+        bool shouldDrawButtonAsHighlighted, bool shouldDrawButtonAsDown) override
     {
-        auto bounds = button.getLocalBounds().toFloat();
-        auto circleBounds = bounds.withSizeKeepingCentre(bounds.getHeight(), bounds.getHeight()).reduced(2.0f); // Make it a circle
+        const auto variant = 1 + (shouldDrawButtonAsHighlighted ? 1 : 0) + (shouldDrawButtonAsDown ? 2 : 0)
+            + (button.isConnectedOnLeft() ? 4 : 0) + (button.isConnectedOnRight() ? 8 : 0)
+            + (button.isConnectedOnTop() ? 16 : 0) + (button.isConnectedOnBottom() ? 32 : 0)
+            + (button.hasKeyboardFocus(true) ? 64 : 0) + (button.isEnabled() ? 128 : 0);
+
+        drawCached(g, button.getLocalBounds().toFloat(), variant, backgroundColour.getARGB(),
+            [&](juce::Graphics& ig, juce::Rectangle<float> area) {
+                ig.addTransform(juce::AffineTransform::translation(area.getX(), area.getY())); // V4 draws at the button's origin
+                LookAndFeel_V4::drawButtonBackground(ig, button, backgroundColour, shouldDrawButtonAsHighlighted, shouldDrawButtonAsDown);
+            });
+    }
 
-        if (button.getToggleState())
-        {
-            // --- ON STATE (Illuminated) ---
-            juce::Colour onColour = findColour(juce::TextButton::buttonOnColourId);
-            // Glow effect
-            g.setColour(onColour.withAlpha(0.3f));
-            g.fillEllipse(circleBounds.expanded(3.0f));
-
-            // Main light
-            juce::ColourGradient lightGradient(juce::Colours::white, circleBounds.getCentreX(), circleBounds.getCentreY() - circleBounds.getHeight() * 0.5f,
-                onColour, circleBounds.getCentreX(), circleBounds.getCentreY() + circleBounds.getHeight(), true);
-            g.setGradientFill(lightGradient);
-            g.fillEllipse(circleBounds);
-        }
-        else
+private:
+    // Static artwork is rendered once per size, scale factor, variant and colour at the display's pixel density, then blitted
+    template <typename Painter>
+    void drawCached(juce::Graphics& g, juce::Rectangle<float> area, int variant, juce::uint32 colour, Painter&& paintArtwork)
+    {
+        constexpr float margin = 4.0f; // Room for outlines and glows that reach past the area
+        const auto scale = g.getInternalContext().getPhysicalPixelScaleFactor();
+        const auto key = std::make_tuple(juce::roundToInt(area.getWidth() * 4.0f), juce::roundToInt(area.getHeight() * 4.0f),
+            juce::roundToInt(scale * 100.0f), variant, colour);
+
+        auto it = imageCache.find(key);
+        if (it == imageCache.end())
         {
-            // --- OFF STATE ---
-            juce::Colour offColour = findColour(juce::TextButton::buttonColourId);
-            juce::ColourGradient darkGradient(offColour.brighter(0.1f), circleBounds.getCentreX(), circleBounds.getCentreY() - circleBounds.getHeight() * 0.5f,
-                offColour.darker(0.5f), circleBounds.getCentreX(), circleBounds.getCentreY() + circleBounds.getHeight(), true);
-            g.setGradientFill(darkGradient);
-            g.fillEllipse(circleBounds);
-
-            // Inner shadow to give depth
-            g.setColour(juce::Colours::black.withAlpha(0.5f));
-            g.drawEllipse(circleBounds, 1.0f);
+            if (imageCache.size() >= maxCachedImages) // Only a resize sweep gets here; start over rather than grow
+                imageCache.clear();
+
+            juce::Image image(juce::Image::ARGB, juce::jmax(1, juce::roundToInt((area.getWidth() + 2.0f * margin) * scale)),
+                juce::jmax(1, juce::roundToInt((area.getHeight() + 2.0f * margin) * scale)), true);
+            {
+                juce::Graphics ig(image);
+                ig.addTransform(juce::AffineTransform::scale(scale));
+                paintArtwork(ig, area.withPosition(margin, margin));
+            }
+
+            it = imageCache.emplace(key, std::move(image)).first;
         }
+
+        g.drawImage(it->second, area.expanded(margin));
     }
 
-private:
+    static constexpr size_t maxCachedImages = 64;
+    std::map<std::tuple<int, int, int, int, juce::uint32>, juce::Image> imageCache;
     juce::Colour apiBlue;
 };
 
 Api550bAudioProcessorEditor::Api550bAudioProcessorEditor(Api550bAudioProcessor& p)
-    : AudioProcessorEditor(&p), audioProcessor(p)
+    : AudioProcessorEditor(&p), audioProcessor(p), analyser(p)
 {
-    laf = std::make_unique<ApiLookAndFeel>();
+    addAndMakeVisible(analyser);
+#if EQALPHA_PROFILING
+    addAndMakeVisible(profilerOverlay); // Added after the analyser, so it sits on top
+#endif
+
+    setOpaque(true); // paint() covers everything, so nothing behind the editor has to be drawn first
+
     setLookAndFeel(laf.get());
 
     setupSlider(lowFreqSlider);
@@ -126,6 +151,8 @@ Api550bAudioProcessorEditor::Api550bAudioProcessorEditor(Api550bAudioProcessor&
     setupLabel(highMuteLabel, "MUTE", 12.0f);
     setupLabel(highBypassLabel, "BYPASS", 12.0f);
     setupLabel(satDriveLabel, "DRIVE", 16.0f, true);
+    setupLabel(autoGainLabel, {}, 12.0f);
+    setupLabel(loudnessLabel, {}, 11.0f);
 
     auto setupButton = [&](juce::Button& button, const juce::String& text) {
         addAndMakeVisible(button);
@@ -137,6 +164,11 @@ Api550bAudioProcessorEditor::Api550bAudioProcessorEditor(Api550bAudioProcessor&
     setupButton(lowShelfButton, "SHELF");
     setupButton(highShelfButton, "SHELF");
     setupButton(qModeButton, "Q MODE");
+    setupButton(autoGainButton, "AUTO");
+    autoGainButton.setTooltip("Auto gain: keeps the output as loud as the input (BS.1770 short-term loudness)");
+    setupButton(channelLinkButton, "LINK");
+    channelLinkButton.setTooltip("Channel link: off, each channel runs the first or second band set, as its Band Set parameter picks");
+    channelLinkButton.onClick = [this] { updateEditSetButtons(); };
     setupButton(lowMuteButton, "MUTE");
     setupButton(lowBypassButton, "BYPASS");
     setupButton(lmMuteButton, "MUTE");
@@ -146,30 +178,89 @@ Api550bAudioProcessorEditor::Api550bAudioProcessorEditor(Api550bAudioProcessor&
     setupButton(highMuteButton, "MUTE");
     setupButton(highBypassButton, "BYPASS");
 
-    lowFreqAttachment = std::make_unique<SliderAttachment>(audioProcessor.apvts, Params::LOW_FREQ, lowFreqSlider);
-    lowGainAttachment = std::make_unique<SliderAttachment>(audioProcessor.apvts, Params::LOW_GAIN, lowGainSlider);
-    lowShelfAttachment = std::make_unique<ButtonAttachment>(audioProcessor.apvts, Params::LOW_SHELF, lowShelfButton);
-    lowMuteAttachment = std::make_unique<ButtonAttachment>(audioProcessor.apvts, Params::LOW_MUTE, lowMuteButton);
-    lowBypassAttachment = std::make_unique<ButtonAttachment>(audioProcessor.apvts, Params::LOW_BYPASS, lowBypassButton);
-    lowMidFreqAttachment = std::make_unique<SliderAttachment>(audioProcessor.apvts, Params::LM_FREQ, lowMidFreqSlider);
-    lowMidGainAttachment = std::make_unique<SliderAttachment>(audioProcessor.apvts, Params::LM_GAIN, lowMidGainSlider);
-    lmMuteAttachment = std::make_unique<ButtonAttachment>(audioProcessor.apvts, Params::LM_MUTE, lmMuteButton);
-    lmBypassAttachment = std::make_unique<ButtonAttachment>(audioProcessor.apvts, Params::LM_BYPASS, lmBypassButton);
-    highMidFreqAttachment = std::make_unique<SliderAttachment>(audioProcessor.apvts, Params::HM_FREQ, highMidFreqSlider);
-    highMidGainAttachment = std::make_unique<SliderAttachment>(audioProcessor.apvts, Params::HM_GAIN, highMidGainSlider);
-    hmMuteAttachment = std::make_unique<ButtonAttachment>(audioProcessor.apvts, Params::HM_MUTE, hmMuteButton);
-    hmBypassAttachment = std::make_unique<ButtonAttachment>(audioProcessor.apvts, Params::HM_BYPASS, hmBypassButton);
-    highFreqAttachment = std::make_unique<SliderAttachment>(audioProcessor.apvts, Params::HIGH_FREQ, highFreqSlider);
-    highGainAttachment = std::make_unique<SliderAttachment>(audioProcessor.apvts, Params::HIGH_GAIN, highGainSlider);
-    highShelfAttachment = std::make_unique<ButtonAttachment>(audioProcessor.apvts, Params::HIGH_SHELF, highShelfButton);
-    highMuteAttachment = std::make_unique<ButtonAttachment>(audioProcessor.apvts, Params::HIGH_MUTE, highMuteButton);
-    highBypassAttachment = std::make_unique<ButtonAttachment>(audioProcessor.apvts, Params::HIGH_BYPASS, highBypassButton);
-    satDriveAttachment = std::make_unique<SliderAttachment>(audioProcessor.apvts, Params::SAT_DRIVE, satDriveSlider);
-    qModeAttachment = std::make_unique<ButtonAttachment>(audioProcessor.apvts, Params::Q_MODE, qModeButton);
-
-    setSize(700, 480); // Reverted to original size, as layout fits
+    for (auto& button : dynamicButtons)
+    {
+        setupButton(button, "DYN");
+        button.setTooltip("Dynamic mode: the band's gain follows its own level above the threshold");
+    }
+
+    oversamplingBox.addItemList({ "1x", "2x", "4x", "8x" }, 1); // Must match the SAT_OVERSAMPLING choices
+    oversamplingBox.setTooltip("Saturation oversampling");
+    addAndMakeVisible(oversamplingBox);
+
+    cutLevelBox.addItemList({ "-6", "-12", "-18", "-24", "-36", "-48" }, 1); // Must match the MUTE_CUT choices
+    cutLevelBox.setTooltip("How deep a muted band cuts (dB)");
+    addAndMakeVisible(cutLevelBox);
+
+    phaseModeBox.addItemList({ "Minimum", "Linear" }, 1); // Must match the PHASE_MODE choices
+    phaseModeBox.setTooltip("Minimum phase (no latency) or linear phase (adds latency)");
+    addAndMakeVisible(phaseModeBox);
+
+    continuousBox.addItemList({ "Stepped", "Continuous" }, 1); // CONTINUOUS off and on
+    continuousBox.setTooltip("The 550B's frequency and gain steps, or any value in between (left or mid set only)");
+    continuousBox.onChange = [this] { updateBandBinding(); };
+    addAndMakeVisible(continuousBox);
+
+    stereoModeBox.addItemList({ "Linked", "Dual Mono", "Mid/Side" }, 1); // Must match the STEREO_MODE choices
+    stereoModeBox.setTooltip("Linked, separate left and right, or separate mid and side settings");
+    stereoModeBox.onChange = [this] { updateEditSetButtons(); };
+    addAndMakeVisible(stereoModeBox);
+
+    for (size_t set = 0; set < editSetButtons.size(); ++set)
+    {
+        auto& button = editSetButtons[set];
+        addAndMakeVisible(button);
+        button.setButtonText(set == 0 ? "L/M" : "R/S");
+        button.setTooltip(set == 0 ? "Edit the left or mid channel, or the first set when unlinked" : "Edit the right or side channel, or the second set when unlinked");
+        button.setRadioGroupId(2);
+        button.setClickingTogglesState(true);
+        button.setToggleState(set == 0, juce::dontSendNotification);
+        button.onClick = [this, set] {
+            if (editSetButtons[set].getToggleState())
+                updateBandBinding();
+            };
+    }
+
+    for (int slot = 0; slot < Api550bAudioProcessor::numSnapshotSlots; ++slot)
+    {
+        auto& button = snapshotButtons[static_cast<size_t>(slot)];
+        addAndMakeVisible(button);
+        button.setButtonText(juce::String::charToString(static_cast<juce::juce_wchar>('A' + slot)));
+        button.setTooltip("Snapshot " + button.getButtonText() + ": stores the current settings and recalls this slot");
+        button.setRadioGroupId(1);
+        button.setClickingTogglesState(true);
+        button.setToggleState(slot == audioProcessor.getActiveSnapshot(), juce::dontSendNotification);
+        button.onClick = [this, slot] {
+            if (snapshotButtons[static_cast<size_t>(slot)].getToggleState())
+                audioProcessor.selectSnapshot(slot);
+            };
+    }
+
+    continuousAttachment = std::make_unique<ComboBoxAttachment>(attachmentGroup, audioProcessor.apvts, Params::CONTINUOUS, continuousBox);
+    attachBandControls(false);
+    qModeAttachment = std::make_unique<ButtonAttachment>(attachmentGroup, audioProcessor.apvts, Params::Q_MODE, qModeButton);
+    autoGainAttachment = std::make_unique<ButtonAttachment>(attachmentGroup, audioProcessor.apvts, Params::AUTO_GAIN, autoGainButton);
+    oversamplingAttachment = std::make_unique<ComboBoxAttachment>(attachmentGroup, audioProcessor.apvts, Params::SAT_OVERSAMPLING, oversamplingBox);
+    cutLevelAttachment = std::make_unique<ComboBoxAttachment>(attachmentGroup, audioProcessor.apvts, Params::MUTE_CUT, cutLevelBox);
+    phaseModeAttachment = std::make_unique<ComboBoxAttachment>(attachmentGroup, audioProcessor.apvts, Params::PHASE_MODE, phaseModeBox);
+    stereoModeAttachment = std::make_unique<ComboBoxAttachment>(attachmentGroup, audioProcessor.apvts, Params::STEREO_MODE, stereoModeBox);
+    channelLinkAttachment = std::make_unique<ButtonAttachment>(attachmentGroup, audioProcessor.apvts, Params::CHANNEL_LINK, channelLinkButton);
+    updateEditSetButtons();
+
+    // Host changes to the stereo mode, the channel link or continuous mode re-point the band controls once the group's tick is over,
+    // since that destroys and recreates attachments
+    attachmentGroup.onRefresh = [this] { updateEditSetButtons(); };
+
+    const juce::String* dynamicIDs[] = { &Params::LOW_DYN, &Params::LM_DYN, &Params::HM_DYN, &Params::HIGH_DYN };
+    for (size_t band = 0; band < dynamicButtons.size(); ++band)
+        dynamicAttachments[band] = std::make_unique<ButtonAttachment>(attachmentGroup, audioProcessor.apvts, *dynamicIDs[band], dynamicButtons[band]);
+
+    setSize(700, 510 + analyserHeight); // Taller to fit the oversampling selector under DRIVE and the analyser
     setResizable(true, true);
-    setResizeLimits(600, 420, 1200, 840);
+    setResizeLimits(600, 450 + analyserHeight, 1200, 840);
+
+    timerCallback();
+    startTimerHz(10);
 }
 
 Api550bAudioProcessorEditor::~Api550bAudioProcessorEditor()
@@ -178,12 +269,31 @@ Api550bAudioProcessorEditor::~Api550bAudioProcessorEditor()
 }
 
 void Api550bAudioProcessorEditor::paint(juce::Graphics& g)
+{
+    // Nothing in the background depends on a parameter, so it is only drawn again after a resize or a scale change
+    const auto scale = g.getInternalContext().getPhysicalPixelScaleFactor();
+    if (!backgroundImage.isValid() || backgroundScale != scale)
+    {
+        backgroundScale = scale;
+        backgroundImage = juce::Image(juce::Image::RGB, juce::jmax(1, juce::roundToInt(getWidth() * scale)),
+            juce::jmax(1, juce::roundToInt(getHeight() * scale)), false);
+
+        juce::Graphics ig(backgroundImage);
+        ig.addTransform(juce::AffineTransform::scale(scale));
+        paintBackground(ig);
+    }
+
+    g.drawImage(backgroundImage, getLocalBounds().toFloat());
+}
+
+void Api550bAudioProcessorEditor::paintBackground(juce::Graphics& g) const
 {
     g.fillAll(juce::Colour(0xff00529e)); // API blue background
     auto bounds = getLocalBounds();
     g.setColour(juce::Colours::lightgrey);
     g.setFont(juce::FontOptions(22.0f, juce::Font::bold));
     g.drawText("EQ Alpha 3", bounds.removeFromTop(50), juce::Justification::centred, true);
+    bounds.removeFromTop(analyserHeight);
 
     auto panelBounds = bounds.reduced(10);
     g.setColour(juce::Colour(0xff1a1a1a));
@@ -200,8 +310,22 @@ void Api550bAudioProcessorEditor::paint(juce::Graphics& g)
 
 void Api550bAudioProcessorEditor::resized()
 {
+    backgroundImage = {};
+
     auto bounds = getLocalBounds();
-    bounds.removeFromTop(50); // Space for title
+    auto titleArea = bounds.removeFromTop(50); // Space for title
+    phaseModeBox.setBounds(titleArea.removeFromRight(110).withSizeKeepingCentre(90, 24));
+    stereoModeBox.setBounds(titleArea.removeFromRight(100).withSizeKeepingCentre(90, 24));
+    titleArea.removeFromLeft(10);
+    for (auto& button : snapshotButtons)
+        button.setBounds(titleArea.removeFromLeft(30).withSizeKeepingCentre(26, 24));
+    titleArea.removeFromLeft(10);
+    for (auto& button : editSetButtons)
+        button.setBounds(titleArea.removeFromLeft(40).withSizeKeepingCentre(36, 24));
+    analyser.setBounds(bounds.removeFromTop(analyserHeight).reduced(10, 5));
+#if EQALPHA_PROFILING
+    profilerOverlay.setBounds(analyser.getBounds().withSizeKeepingCentre(330, 110).withX(analyser.getX() + 5));
+#endif
     bounds.reduce(15, 15);
 
     const int numBands = 4;
@@ -259,6 +383,7 @@ void Api550bAudioProcessorEditor::resized()
     for (int i = 0; i < numBands; ++i)
     {
         auto column = bounds.withX(bounds.getX() + i * (bandWidth + 10)).withWidth(bandWidth);
+        dynamicButtons[static_cast<size_t>(i)].setBounds(column.withHeight(25).withLeft(column.getRight() - 40).reduced(2));
 
         if (i == 0) // Low Band: Mute, Bypass, Shelf
         {
@@ -281,6 +406,104 @@ void Api550bAudioProcessorEditor::resized()
                 nullptr, &highMuteButton, &highMuteLabel, &highBypassButton, &highBypassLabel);
         }
     }
+
+    // Oversampling selector sits right under the drive knob
+    oversamplingBox.setBounds(juce::Rectangle<int>(70, 22).withCentre({ satDriveSlider.getBounds().getCentreX(), satDriveSlider.getBottom() + 15 }));
+
+    // Mute cut level sits under the Q MODE button
+    cutLevelBox.setBounds(juce::Rectangle<int>(70, 22).withCentre({ qModeButton.getBounds().getCentreX(), qModeButton.getBottom() + 20 }));
+
+    // Stepped or continuous sits under the low band's SHELF button
+    continuousBox.setBounds(juce::Rectangle<int>(100, 22).withCentre({ lowShelfButton.getBounds().getCentreX(), lowShelfButton.getBottom() + 20 }));
+
+    // Channel link sits under that
+    channelLinkButton.setBounds(juce::Rectangle<int>(60, 22).withCentre({ continuousBox.getBounds().getCentreX(), continuousBox.getBottom() + 16 }));
+
+    // Auto gain and its readings sit under the high band's SHELF button
+    auto autoGainRow = juce::Rectangle<int>(120, 22).withCentre({ highShelfButton.getBounds().getCentreX(), highShelfButton.getBottom() + 20 });
+    autoGainButton.setBounds(autoGainRow.removeFromLeft(50).reduced(0, 1));
+    autoGainLabel.setBounds(autoGainRow);
+    loudnessLabel.setBounds(juce::Rectangle<int>(bandWidth, 16).withCentre({ highShelfButton.getBounds().getCentreX(), autoGainRow.getBottom() + 12 }));
+}
+
+void Api550bAudioProcessorEditor::timerCallback()
+{
+    // A session load or a host program change can switch the slot behind the editor's back
+    const auto activeSnapshot = audioProcessor.getActiveSnapshot();
+    if (!snapshotButtons[static_cast<size_t>(activeSnapshot)].getToggleState())
+        snapshotButtons[static_cast<size_t>(activeSnapshot)].setToggleState(true, juce::dontSendNotification);
+
+    const auto& autoGain = audioProcessor.getAutoGain();
+    const auto active = autoGainButton.getToggleState();
+    auto lufs = [](float value) { return value > AutoGain::gateLufs ? juce::String(value, 1) : juce::String("--"); };
+
+    autoGainLabel.setText(active ? juce::String(autoGain.getGainDb(), 1) + " dB" : juce::String(), juce::dontSendNotification);
+    loudnessLabel.setText(active ? "In " + lufs(autoGain.getInputLoudness()) + " / EQ " + lufs(autoGain.getOutputLoudness()) + " LUFS" : juce::String(),
+        juce::dontSendNotification);
+}
+
+// Points the band controls and the drive at one of the two band sets; the dynamics buttons and continuous mode only
+// exist for the first
+void Api550bAudioProcessorEditor::attachBandControls(bool secondSet)
+{
+    auto& state = audioProcessor.apvts;
+    auto id = [secondSet](const juce::String& first, const juce::String& second) -> const juce::String& { return secondSet ? second : first; };
+
+    // Frequency and gain knobs: the first set's continuous parameters, its steps, or the second set's steps
+    const auto continuous = !secondSet && continuousBox.getSelectedItemIndex() == 1;
+    boundToSecondSet = secondSet;
+    boundToContinuous = continuous;
+    auto knobId = [&](const juce::String& stepped, const juce::String& second, const juce::String& continuousID) -> const juce::String& {
+        return continuous ? continuousID : id(stepped, second);
+        };
+
+    lowFreqAttachment = std::make_unique<SliderAttachment>(attachmentGroup, state, knobId(Params::LOW_FREQ, Params::LOW_FREQ_B, Params::LOW_FREQ_C), lowFreqSlider);
+    lowGainAttachment = std::make_unique<SliderAttachment>(attachmentGroup, state, knobId(Params::LOW_GAIN, Params::LOW_GAIN_B, Params::LOW_GAIN_C), lowGainSlider);
+    lowShelfAttachment = std::make_unique<ButtonAttachment>(attachmentGroup, state, id(Params::LOW_SHELF, Params::LOW_SHELF_B), lowShelfButton);
+    lowMuteAttachment = std::make_unique<ButtonAttachment>(attachmentGroup, state, id(Params::LOW_MUTE, Params::LOW_MUTE_B), lowMuteButton);
+    lowBypassAttachment = std::make_unique<ButtonAttachment>(attachmentGroup, state, id(Params::LOW_BYPASS, Params::LOW_BYPASS_B), lowBypassButton);
+    lowMidFreqAttachment = std::make_unique<SliderAttachment>(attachmentGroup, state, knobId(Params::LM_FREQ, Params::LM_FREQ_B, Params::LM_FREQ_C), lowMidFreqSlider);
+    lowMidGainAttachment = std::make_unique<SliderAttachment>(attachmentGroup, state, knobId(Params::LM_GAIN, Params::LM_GAIN_B, Params::LM_GAIN_C), lowMidGainSlider);
+    lmMuteAttachment = std::make_unique<ButtonAttachment>(attachmentGroup, state, id(Params::LM_MUTE, Params::LM_MUTE_B), lmMuteButton);
+    lmBypassAttachment = std::make_unique<ButtonAttachment>(attachmentGroup, state, id(Params::LM_BYPASS, Params::LM_BYPASS_B), lmBypassButton);
+    highMidFreqAttachment = std::make_unique<SliderAttachment>(attachmentGroup, state, knobId(Params::HM_FREQ, Params::HM_FREQ_B, Params::HM_FREQ_C), highMidFreqSlider);
+    highMidGainAttachment = std::make_unique<SliderAttachment>(attachmentGroup, state, knobId(Params::HM_GAIN, Params::HM_GAIN_B, Params::HM_GAIN_C), highMidGainSlider);
+    hmMuteAttachment = std::make_unique<ButtonAttachment>(attachmentGroup, state, id(Params::HM_MUTE, Params::HM_MUTE_B), hmMuteButton);
+    hmBypassAttachment = std::make_unique<ButtonAttachment>(attachmentGroup, state, id(Params::HM_BYPASS, Params::HM_BYPASS_B), hmBypassButton);
+    highFreqAttachment = std::make_unique<SliderAttachment>(attachmentGroup, state, knobId(Params::HIGH_FREQ, Params::HIGH_FREQ_B, Params::HIGH_FREQ_C), highFreqSlider);
+    highGainAttachment = std::make_unique<SliderAttachment>(attachmentGroup, state, knobId(Params::HIGH_GAIN, Params::HIGH_GAIN_B, Params::HIGH_GAIN_C), highGainSlider);
+    highShelfAttachment = std::make_unique<ButtonAttachment>(attachmentGroup, state, id(Params::HIGH_SHELF, Params::HIGH_SHELF_B), highShelfButton);
+    highMuteAttachment = std::make_unique<ButtonAttachment>(attachmentGroup, state, id(Params::HIGH_MUTE, Params::HIGH_MUTE_B), highMuteButton);
+    highBypassAttachment = std::make_unique<ButtonAttachment>(attachmentGroup, state, id(Params::HIGH_BYPASS, Params::HIGH_BYPASS_B), highBypassButton);
+    satDriveAttachment = std::make_unique<SliderAttachment>(attachmentGroup, state, id(Params::SAT_DRIVE, Params::SAT_DRIVE_B), satDriveSlider);
+
+    for (auto& button : dynamicButtons)
+        button.setEnabled(!secondSet);
+}
+
+// The second set only does something when the stereo mode or the channel link splits the channels, so editing it is
+// only offered then
+void Api550bAudioProcessorEditor::updateEditSetButtons()
+{
+    const auto linked = stereoModeBox.getSelectedItemIndex() <= 0 && channelLinkButton.getToggleState();
+
+    for (auto& button : editSetButtons)
+        button.setEnabled(!linked);
+
+    if (linked && editSetButtons[1].getToggleState())
+        editSetButtons[0].setToggleState(true, juce::dontSendNotification);
+
+    updateBandBinding();
+}
+
+// Re-attaches the band controls when the edited set or continuous mode no longer match what they are bound to
+void Api550bAudioProcessorEditor::updateBandBinding()
+{
+    const auto secondSet = editSetButtons[1].getToggleState();
+    const auto continuous = !secondSet && continuousBox.getSelectedItemIndex() == 1;
+
+    if (secondSet != boundToSecondSet || continuous != boundToContinuous)
+        attachBandControls(secondSet);
 }
 
 void Api550bAudioProcessorEditor::setupSlider(juce::Slider& slider)
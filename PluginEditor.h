@@ -1,10 +1,13 @@
 #pragma once
 #include <JuceHeader.h>
 #include "PluginProcessor.h"
+#include "SpectrumAnalyserComponent.h"
+#include "ProfilerOverlay.h"
+#include "PolledAttachment.h"
 
 class ApiLookAndFeel;
 
-class Api550bAudioProcessorEditor : public juce::AudioProcessorEditor
+class Api550bAudioProcessorEditor : public juce::AudioProcessorEditor, private juce::Timer
 {
 public:
     Api550bAudioProcessorEditor(Api550bAudioProcessor&);
@@ -16,10 +19,21 @@ public:
 private:
     Api550bAudioProcessor& audioProcessor;
 
+    static constexpr int analyserHeight = 150; // Strip between the title and the band panels
+    SpectrumAnalyserComponent analyser;
+#if EQALPHA_PROFILING
+    ProfilerOverlay profilerOverlay{ audioProcessor.getProfiler() };
+#endif
+
     juce::Slider lowFreqSlider, lowMidFreqSlider, highMidFreqSlider, highFreqSlider;
     juce::Slider lowGainSlider, lowMidGainSlider, highMidGainSlider, highGainSlider;
     juce::Slider satDriveSlider;
-    juce::TextButton lowShelfButton, highShelfButton, qModeButton;
+    juce::TextButton lowShelfButton, highShelfButton, qModeButton, autoGainButton;
+    juce::TextButton channelLinkButton; // Each channel's band set is a host parameter
+    juce::ComboBox oversamplingBox, cutLevelBox, phaseModeBox, stereoModeBox, continuousBox;
+    std::array<juce::TextButton, 2> editSetButtons; // Which band set the knobs show: left/mid or right/side
+    std::array<juce::TextButton, Api550bAudioProcessor::numSnapshotSlots> snapshotButtons; // A/B/C/D comparison
+    std::array<juce::TextButton, CoefficientBank::numBands> dynamicButtons; // Threshold, ratio and times are host parameters
     juce::TextButton lowMuteButton, lowBypassButton;
     juce::TextButton lmMuteButton, lmBypassButton;
     juce::TextButton hmMuteButton, hmBypassButton;
@@ -30,22 +44,38 @@ private:
     juce::Label hmMuteLabel, hmBypassLabel;
     juce::Label highMuteLabel, highBypassLabel;
     juce::Label satDriveLabel; // Kept for DRIVE label
+    juce::Label autoGainLabel, loudnessLabel; // Auto-gain's gain, and the input and output loudness it's matching
 
-    using SliderAttachment = juce::AudioProcessorValueTreeState::SliderAttachment;
-    using ButtonAttachment = juce::AudioProcessorValueTreeState::ButtonAttachment;
+    // Polled rather than listening, so automation updates the controls once per timer tick (see PolledAttachment)
+    using SliderAttachment = PolledAttachment;
+    using ButtonAttachment = PolledAttachment;
+    using ComboBoxAttachment = PolledAttachment;
+    PolledAttachment::Group attachmentGroup; // Before the attachments, which unregister from it
 
     std::unique_ptr<SliderAttachment> lowFreqAttachment, lowGainAttachment, lowMidFreqAttachment, lowMidGainAttachment;
     std::unique_ptr<SliderAttachment> highMidFreqAttachment, highMidGainAttachment, highFreqAttachment, highGainAttachment;
     std::unique_ptr<SliderAttachment> satDriveAttachment;
-    std::unique_ptr<ButtonAttachment> lowShelfAttachment, highShelfAttachment, qModeAttachment;
+    std::unique_ptr<ButtonAttachment> lowShelfAttachment, highShelfAttachment, qModeAttachment, autoGainAttachment;
+    std::unique_ptr<ButtonAttachment> channelLinkAttachment;
     std::unique_ptr<ButtonAttachment> lowMuteAttachment, lowBypassAttachment;
     std::unique_ptr<ButtonAttachment> lmMuteAttachment, lmBypassAttachment;
     std::unique_ptr<ButtonAttachment> hmMuteAttachment, hmBypassAttachment;
     std::unique_ptr<ButtonAttachment> highMuteAttachment, highBypassAttachment;
+    std::unique_ptr<ComboBoxAttachment> oversamplingAttachment, cutLevelAttachment, phaseModeAttachment, stereoModeAttachment, continuousAttachment;
+    std::array<std::unique_ptr<ButtonAttachment>, CoefficientBank::numBands> dynamicAttachments;
+
+    juce::SharedResourcePointer<ApiLookAndFeel> laf; // One for every open editor, so its artwork cache is shared too
 
-    std::unique_ptr<ApiLookAndFeel> laf;
+    juce::Image backgroundImage; // Background, title and panels; dropped on resize
+    float backgroundScale = 0.0f;
 
     void setupSlider(juce::Slider& slider);
+    void paintBackground(juce::Graphics& g) const;
+    void attachBandControls(bool secondSet);
+    void updateEditSetButtons();
+    void updateBandBinding();
+    bool boundToSecondSet = false, boundToContinuous = false; // What attachBandControls last bound the band controls to
+    void timerCallback() override; // Polls the auto-gain readings
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(Api550bAudioProcessorEditor)
 };
\ No newline at end of file
@@ -1,13 +1,57 @@
 #include "PluginProcessor.h"
 #include "PluginEditor.h"
+#include <algorithm>
 #include <cmath>
+#include <limits>
 
 juce::AudioProcessor* JUCE_CALLTYPE createPluginFilter()
 {
     return new Api550bAudioProcessor();
 }
 
-float Api550bAudioProcessor::Impl::saturationDrive = 2.0f;
+namespace
+{
+    // Parameter IDs of each band, in CoefficientBank::Band order. Only the low and high bands have a shelf,
+    // only the first set has dynamics and continuous mode.
+    struct BandParameterIDs
+    {
+        const juce::String* freq;
+        const juce::String* gain;
+        const juce::String* shelf;
+        const juce::String* mute;
+        const juce::String* bypass;
+        const juce::String* dynamic;
+        const juce::String* threshold;
+        const juce::String* ratio;
+        const juce::String* attack;
+        const juce::String* release;
+        const juce::String* continuousFreq;
+        const juce::String* continuousGain;
+    };
+
+    const std::array<BandParameterIDs, CoefficientBank::numBands> bandParameterIDs{ {
+        { &Params::LOW_FREQ, &Params::LOW_GAIN, &Params::LOW_SHELF, &Params::LOW_MUTE, &Params::LOW_BYPASS,
+          &Params::LOW_DYN, &Params::LOW_THRESHOLD, &Params::LOW_RATIO, &Params::LOW_ATTACK, &Params::LOW_RELEASE,
+          &Params::LOW_FREQ_C, &Params::LOW_GAIN_C },
+        { &Params::LM_FREQ, &Params::LM_GAIN, nullptr, &Params::LM_MUTE, &Params::LM_BYPASS,
+          &Params::LM_DYN, &Params::LM_THRESHOLD, &Params::LM_RATIO, &Params::LM_ATTACK, &Params::LM_RELEASE,
+          &Params::LM_FREQ_C, &Params::LM_GAIN_C },
+        { &Params::HM_FREQ, &Params::HM_GAIN, nullptr, &Params::HM_MUTE, &Params::HM_BYPASS,
+          &Params::HM_DYN, &Params::HM_THRESHOLD, &Params::HM_RATIO, &Params::HM_ATTACK, &Params::HM_RELEASE,
+          &Params::HM_FREQ_C, &Params::HM_GAIN_C },
+        { &Params::HIGH_FREQ, &Params::HIGH_GAIN, &Params::HIGH_SHELF, &Params::HIGH_MUTE, &Params::HIGH_BYPASS,
+          &Params::HIGH_DYN, &Params::HIGH_THRESHOLD, &Params::HIGH_RATIO, &Params::HIGH_ATTACK, &Params::HIGH_RELEASE,
+          &Params::HIGH_FREQ_C, &Params::HIGH_GAIN_C },
+    } };
+
+    // The right or side channel's set; it has no dynamics
+    const std::array<BandParameterIDs, CoefficientBank::numBands> secondBandParameterIDs{ {
+        { &Params::LOW_FREQ_B, &Params::LOW_GAIN_B, &Params::LOW_SHELF_B, &Params::LOW_MUTE_B, &Params::LOW_BYPASS_B },
+        { &Params::LM_FREQ_B, &Params::LM_GAIN_B, nullptr, &Params::LM_MUTE_B, &Params::LM_BYPASS_B },
+        { &Params::HM_FREQ_B, &Params::HM_GAIN_B, nullptr, &Params::HM_MUTE_B, &Params::HM_BYPASS_B },
+        { &Params::HIGH_FREQ_B, &Params::HIGH_GAIN_B, &Params::HIGH_SHELF_B, &Params::HIGH_MUTE_B, &Params::HIGH_BYPASS_B },
+    } };
+}
 
 Api550bAudioProcessor::Api550bAudioProcessor()
     : AudioProcessor(BusesProperties()
@@ -15,171 +59,840 @@ Api550bAudioProcessor::Api550bAudioProcessor()
         .withOutput("Output", juce::AudioChannelSet::stereo())),
     apvts(*this, nullptr, "Parameters", createParameterLayout())
 {
-    apvts.addParameterListener(Params::LOW_FREQ, this);
-    apvts.addParameterListener(Params::LOW_GAIN, this);
-    apvts.addParameterListener(Params::LOW_SHELF, this);
-    apvts.addParameterListener(Params::LOW_MUTE, this); // New
-    apvts.addParameterListener(Params::LOW_BYPASS, this); // New
-    apvts.addParameterListener(Params::LM_FREQ, this);
-    apvts.addParameterListener(Params::LM_GAIN, this);
-    apvts.addParameterListener(Params::LM_MUTE, this); // New
-    apvts.addParameterListener(Params::LM_BYPASS, this); // New
-    apvts.addParameterListener(Params::HM_FREQ, this);
-    apvts.addParameterListener(Params::HM_GAIN, this);
-    apvts.addParameterListener(Params::HM_MUTE, this); // New
-    apvts.addParameterListener(Params::HM_BYPASS, this); // New
-    apvts.addParameterListener(Params::HIGH_FREQ, this);
-    apvts.addParameterListener(Params::HIGH_GAIN, this);
-    apvts.addParameterListener(Params::HIGH_SHELF, this);
-    apvts.addParameterListener(Params::HIGH_MUTE, this); // New
-    apvts.addParameterListener(Params::HIGH_BYPASS, this); // New
-    apvts.addParameterListener(Params::SAT_DRIVE, this);
-    apvts.addParameterListener(Params::Q_MODE, this);
-}
+    const auto& parameters = getParameters();
+    const auto& descriptions = ParameterLayout::getDescriptions();
+    jassert(static_cast<size_t>(parameters.size()) == descriptions.size()); // createParameterLayout keeps their order
+    hostValues.resize(static_cast<size_t>(parameters.size()));
+    rangedParameters.resize(hostValues.size());
+    stagedValues = std::make_unique<std::atomic<float>[]>(hostValues.size());
+    recallValues = std::make_unique<std::atomic<float>[]>(hostValues.size());
 
-juce::AudioProcessorValueTreeState::ParameterLayout Api550bAudioProcessor::createParameterLayout()
-{
-    std::vector<std::unique_ptr<juce::RangedAudioParameter>> params;
+    // One listener on the processor for every parameter, tagged per parameter with the part of the DSP it belongs to,
+    // so a change only marks that part
+    for (auto* parameter : parameters)
+    {
+        const auto index = static_cast<size_t>(parameter->getParameterIndex());
+        auto* ranged = dynamic_cast<juce::RangedAudioParameter*>(parameter);
+        rangedParameters[index] = ranged;
+        parameterListener.addParameter(ranged, ranged != nullptr ? descriptions[index].dirtyFlags : 0);
+
+        if (ranged != nullptr)
+            hostValues[index] = apvts.getRawParameterValue(ranged->getParameterID());
+    }
+
+    addListener(&parameterListener);
+    stageAllParameters();
 
-    juce::StringArray lowFreqChoices{ "40", "75", "150", "300", "600", "1.2k", "2.4k" };
-    juce::StringArray highFreqChoices{ "800", "1.5k", "3k", "5k", "7k", "10k", "12.5k" };
-    juce::StringArray gainChoices{ "-12", "-9", "-6", "-3", "0", "3", "6", "9", "12" };
+    auto indexOf = [this](const juce::String& id) { return apvts.getParameter(id)->getParameterIndex(); };
 
-    auto addBand = [&](const juce::String& prefix, const juce::String& name, const juce::StringArray& freqs, int defaultFreqIndex) {
-        params.push_back(std::make_unique<juce::AudioParameterChoice>(prefix + "_FREQ", name + " Freq", freqs, defaultFreqIndex));
-        params.push_back(std::make_unique<juce::AudioParameterChoice>(prefix + "_GAIN", name + " Gain", gainChoices, 4));
-        params.push_back(std::make_unique<juce::AudioParameterBool>(prefix + "_MUTE", name + " Mute", false)); // New: Mute, default off (unmuted)
-        params.push_back(std::make_unique<juce::AudioParameterBool>(prefix + "_BYPASS", name + " Bypass", false)); // New: Bypass, default off (not bypassed)
+    // The same layout twice: the APVTS values for the message thread, the staged values for the DSP
+    auto bindPointers = [&](ParameterPointers& pointers, auto pointerTo) {
+        auto bindBand = [&](const BandParameterIDs& ids, ParameterPointers::Band& b) {
+            b.freq = pointerTo(ids.freq);
+            b.gain = pointerTo(ids.gain);
+            b.shelf = pointerTo(ids.shelf);
+            b.mute = pointerTo(ids.mute);
+            b.bypass = pointerTo(ids.bypass);
+            b.dynamic = pointerTo(ids.dynamic);
+            b.threshold = pointerTo(ids.threshold);
+            b.ratio = pointerTo(ids.ratio);
+            b.attack = pointerTo(ids.attack);
+            b.release = pointerTo(ids.release);
+            b.continuousFreq = pointerTo(ids.continuousFreq);
+            b.continuousGain = pointerTo(ids.continuousGain);
+            };
+
+        for (size_t band = 0; band < bandParameterIDs.size(); ++band)
+        {
+            bindBand(bandParameterIDs[band], pointers.bands[band]);
+            bindBand(secondBandParameterIDs[band], pointers.secondBands[band]);
+        }
+
+        pointers.qMode = pointerTo(&Params::Q_MODE);
+        pointers.drive = pointerTo(&Params::SAT_DRIVE);
+        pointers.oversampling = pointerTo(&Params::SAT_OVERSAMPLING);
+        pointers.muteCut = pointerTo(&Params::MUTE_CUT);
+        pointers.phaseMode = pointerTo(&Params::PHASE_MODE);
+        pointers.stereoMode = pointerTo(&Params::STEREO_MODE);
+        pointers.secondDrive = pointerTo(&Params::SAT_DRIVE_B);
+        pointers.continuous = pointerTo(&Params::CONTINUOUS);
+        pointers.autoGain = pointerTo(&Params::AUTO_GAIN);
+        pointers.channelLink = pointerTo(&Params::CHANNEL_LINK);
+        for (size_t ch = 0; ch < Params::CHANNEL_SETS.size(); ++ch)
+            pointers.channelSets[ch] = pointerTo(&Params::CHANNEL_SETS[ch]);
         };
 
-    addBand("LOW", "Low", lowFreqChoices, 3); // Default 300 Hz
-    params.push_back(std::make_unique<juce::AudioParameterBool>(Params::LOW_SHELF, "Low Shelf", false));
-    addBand("LM", "Low Mid", lowFreqChoices, 4); // Default 600 Hz
-    addBand("HM", "High Mid", highFreqChoices, 2); // Default 3k Hz
-    addBand("HIGH", "High", highFreqChoices, 3); // Default 5k Hz
-    params.push_back(std::make_unique<juce::AudioParameterBool>(Params::HIGH_SHELF, "High Shelf", false));
-    params.push_back(std::make_unique<juce::AudioParameterFloat>(Params::SAT_DRIVE, "Saturation Drive", 0.0f, 10.0f, 2.0f)); // Updated: 0.010.0
-    params.push_back(std::make_unique<juce::AudioParameterBool>(Params::Q_MODE, "Proportional Q", false)); // False = Fixed Q
+    bindPointers(parameterPointers, [&](const juce::String* id) { return id != nullptr ? hostValues[static_cast<size_t>(indexOf(*id))] : nullptr; });
+    bindPointers(stagedPointers, [&](const juce::String* id) {
+        return id != nullptr ? &stagedValues[static_cast<size_t>(indexOf(*id))] : nullptr;
+        });
+
+    snapshotSlots.fill(PackedState::capture(parameterPointers));
+}
+
+Api550bAudioProcessor::~Api550bAudioProcessor()
+{
+    cancelPendingUpdate();
+    removeListener(&parameterListener);
+}
+
+bool Api550bAudioProcessor::isBusesLayoutSupported(const BusesLayout& layouts) const
+{
+    // Any layout up to maxChannels (mono, stereo, 5.1, 7.1.4, third-order ambisonics, ...) as long as in and out match.
+    // Linked, every channel gets the same settings; unlinked, each gets the band set it picks. The channels are processed
+    // a SIMD group at a time either way.
+    const auto& mainOutput = layouts.getMainOutputChannelSet();
+    return !mainOutput.isDisabled() && mainOutput.size() <= maxChannels && layouts.getMainInputChannelSet() == mainOutput;
+}
+
+juce::AudioProcessorValueTreeState::ParameterLayout Api550bAudioProcessor::createParameterLayout()
+{
+    juce::AudioProcessorValueTreeState::ParameterLayout layout;
+    for (const auto& description : ParameterLayout::getDescriptions())
+        layout.add(description.create());
 
-    return { params.begin(), params.end() };
+    return layout;
 }
 
 void Api550bAudioProcessor::prepareToPlay(double sampleRate, int samplesPerBlock)
 {
     juce::dsp::ProcessSpec spec{ sampleRate, static_cast<juce::uint32>(samplesPerBlock), static_cast<juce::uint32>(getTotalNumInputChannels()) };
-    lowFilter.prepare(spec);
-    lowMidFilter.prepare(spec);
-    highMidFilter.prepare(spec);
-    highFilter.prepare(spec);
-    saturation.prepare(spec);
 
-    updateFilters(); // Initial update to set saturation and filters
+    // isBusesLayoutSupported keeps this within what the chains have lanes for
+    jassert(getTotalNumInputChannels() <= maxChannels);
+
+    // Both chains are kept prepared, so a host switching precision between runs finds either one ready
+    forEachChain([&](auto& chain) { chain.prepare(spec); });
+
+    coefficientBank.prepare(sampleRate);
+    continuousTable.prepare(sampleRate);
+    bandDetector.prepare(sampleRate);
+
+    // BS.1770's channel weights: the side surrounds count 1.41, the LFE not at all
+    std::vector<float> loudnessWeights;
+    const auto layout = getChannelLayoutOfBus(true, 0);
+    for (int ch = 0; ch < getTotalNumInputChannels(); ++ch)
+    {
+        const auto type = layout.getTypeOfChannel(ch);
+        const auto isLfe = type == juce::AudioChannelSet::LFE || type == juce::AudioChannelSet::LFE2;
+        const auto isSideSurround = type == juce::AudioChannelSet::leftSurround || type == juce::AudioChannelSet::rightSurround
+            || type == juce::AudioChannelSet::leftSurroundSide || type == juce::AudioChannelSet::rightSurroundSide;
+        loudnessWeights.push_back(isLfe ? 0.0f : isSideSurround ? 1.41f : 1.0f);
+    }
+
+    autoGain.prepare(sampleRate, samplesPerBlock, loudnessWeights);
+    linearPhaseEq.prepare(spec);
+    linearPhaseEq.reset();
+#if EQALPHA_PROFILING
+    profiler.prepare(sampleRate);
+#endif
+    linearPhaseScratch.setSize(static_cast<int>(spec.numChannels), samplesPerBlock);
+
+    silentSamples = 0;
+    dirtyFlags.store(0);
+    appliedRecallSequence = recallSequence.load(std::memory_order_acquire) & ~1u; // An unfinished recall is still taken once it's done
+    stageAllParameters();
+    lastBlockTicks = juce::Time::getHighResolutionTicks();
+    applyParameterChanges(DirtyFlags::all); // Initial update to set saturation and filters
+
+    // Start from the current settings instead of gliding in from wherever the last run ended
+    forEachChain([](auto& chain) {
+        chain.snapFiltersToTargets();
+        chain.saturator.snapToTarget();
+        });
+    linearPhaseEq.snapToSettings();
+
+    // Not on the audio thread, so the host hears of the latency before the stream starts
+    updateLatency();
+    cancelPendingUpdate();
+    handleAsyncUpdate();
+}
+
+void Api550bAudioProcessor::applyParameterChanges(juce::uint32 flags)
+{
+    snapshot.readGlobals(stagedPointers);
+
+    // The path that takes over starts from silence rather than from whatever it held when it was left
+    const auto phaseModeChanged = (flags & DirtyFlags::phaseMode) != 0 && snapshot.linearPhase != linearPhaseActive;
+
+    if (phaseModeChanged)
+    {
+        linearPhaseActive = snapshot.linearPhase;
+        linearPhaseEq.setActive(linearPhaseActive);
+
+        if (linearPhaseActive)
+        {
+            linearPhaseEq.reset();
+        }
+        else
+        {
+            forEachChain([](auto& chain) { chain.resetFilters(); });
+            flags |= DirtyFlags::allBands; // Re-engages the cuts of muted bands
+        }
+    }
+
+    // Two band sets only make sense on a stereo bus, and the linear-phase path only has one.
+    // The filter states belong to the old domain (L/R or M/S), so the cascades restart from silence.
+    const auto stereoMode = getTotalNumInputChannels() == 2 && !linearPhaseActive ? snapshot.stereoMode : StereoMode::linked;
+    const auto stereoModeChanged = stereoMode != activeStereoMode;
+
+    if (stereoModeChanged)
+    {
+        activeStereoMode = stereoMode;
+        forEachChain([this](auto& chain) {
+            chain.resetFilters();
+            chain.setStereoMode(activeStereoMode);
+            });
+        flags |= DirtyFlags::allBands;
+    }
+
+    // Which channels run the second band set: the right or side channel in the stereo modes, otherwise the channels
+    // whose choice picks it while the channels are unlinked. Either way each channel goes through its own lane.
+    auto secondSet = 0u;
+    if (activeStereoMode != StereoMode::linked)
+        secondSet = 1u << 1;
+    else if (!snapshot.channelLink && !linearPhaseActive)
+        secondSet = snapshot.unlinkedSecondSetChannels & ((1u << getTotalNumInputChannels()) - 1);
+
+    if (secondSet != secondSetChannels)
+    {
+        secondSetChannels = secondSet;
+        flags |= DirtyFlags::allBands; // No new domain, so the bands glide to their new sets
+    }
+
+    if ((flags & DirtyFlags::saturation) != 0)
+    {
+        forEachChain([this](auto& chain) {
+            chain.saturator.setDrive(snapshot.drive);
+            chain.saturator.setSecondDrive(snapshot.secondDrive);
+            chain.saturator.setOversamplingIndex(snapshot.oversamplingIndex);
+            });
+    }
+
+    if ((flags & (DirtyFlags::saturation | DirtyFlags::phaseMode)) != 0)
+        updateLatency();
+
+    if ((flags & DirtyFlags::autoGain) != 0)
+        autoGain.setEnabled(snapshot.autoGain);
+
+    // Only the bands that changed are touched. Every section is looked up in the bank or the continuous table,
+    // so nothing here allocates or evaluates trig, and the cascades glide to the new sections over a few sub-blocks.
+    for (int band = 0; band < CoefficientBank::numBands; ++band)
+    {
+        if ((flags & (1u << band)) == 0)
+            continue;
+
+        snapshot.readBand(stagedPointers, band);
+        const auto& settings = snapshot.bands[static_cast<size_t>(band)];
+        const auto section = getBandSection(band, false);
+        const auto cutSection = getBandCut(band, false);
+        const auto* cut = settings.mute && !settings.bypass ? &cutSection : nullptr;
+
+        if (secondSetChannels == 0)
+        {
+            forEachChain([&](auto& chain) { chain.setBand(band, section, cut); });
+        }
+        else
+        {
+            const auto& second = snapshot.secondBands[static_cast<size_t>(band)];
+            const auto secondSection = getBandSection(band, true);
+            const auto secondCutSection = getBandCut(band, true);
+            const auto* secondCut = second.mute && !second.bypass ? &secondCutSection : nullptr;
+            const auto numChannels = static_cast<size_t>(getTotalNumInputChannels());
+
+            forEachChain([&](auto& chain) {
+                for (size_t ch = 0; ch < numChannels; ++ch)
+                {
+                    if ((secondSetChannels & (1u << ch)) != 0)
+                        chain.setBand(band, ch, secondSection, secondCut);
+                    else
+                        chain.setBand(band, ch, section, cut);
+                }
+                });
+        }
+
+        // A band leaving dynamic mode glides back to its static section from wherever its envelope had it
+        const auto& dynamics = snapshot.dynamics[static_cast<size_t>(band)];
+        const auto wasDynamic = dynamicBands != 0;
+
+        if (snapshot.isDynamic(band) && secondSetChannels == 0) // The detector listens to every channel
+        {
+            // Designs its band-pass, so only for bands that use it; continuous automation of the others stays trig free
+            bandDetector.setBand(band, getBandFrequency(band), dynamics.attackMs, dynamics.releaseMs);
+            dynamicBands |= 1u << band;
+        }
+        else
+            dynamicBands &= ~(1u << band);
+
+        if (!wasDynamic && dynamicBands != 0)
+            bandDetector.reset(); // Start from silence rather than from the level when dynamics were last in use
+    }
+
+    // The FIR is designed off the audio thread from the same settings
+    if ((flags & DirtyFlags::allBands) != 0)
+        linearPhaseEq.setSettings(snapshot);
+
+    if ((phaseModeChanged && !linearPhaseActive) || stereoModeChanged)
+        forEachChain([](auto& chain) { chain.snapFiltersToTargets(); });
+
+    updateTailLength();
+}
+
+BiquadCoefficients Api550bAudioProcessor::getBandSection(int band, bool secondSet) const noexcept
+{
+    const auto b = static_cast<size_t>(band);
+
+    if (secondSet)
+        return coefficientBank.get(band, snapshot.secondBands[b], snapshot.proportionalQ);
+
+    return snapshot.continuous ? continuousTable.get(band, snapshot.bands[b], snapshot.continuousBands[b], snapshot.proportionalQ)
+                               : coefficientBank.get(band, snapshot.bands[b], snapshot.proportionalQ);
+}
+
+BiquadCoefficients Api550bAudioProcessor::getBandCut(int band, bool secondSet) const noexcept
+{
+    const auto b = static_cast<size_t>(band);
+
+    if (secondSet)
+        return coefficientBank.getCut(band, snapshot.secondBands[b].freqIndex, snapshot.cutLevelIndex);
+
+    return snapshot.continuous ? continuousTable.getCut(band, snapshot.continuousBands[b].freqHz, snapshot.cutLevelIndex)
+                               : coefficientBank.getCut(band, snapshot.bands[b].freqIndex, snapshot.cutLevelIndex);
+}
+
+float Api550bAudioProcessor::getBandFrequency(int band) const noexcept
+{
+    const auto b = static_cast<size_t>(band);
+    return snapshot.continuous ? snapshot.continuousBands[b].freqHz : CoefficientBank::getFrequency(band, snapshot.bands[b].freqIndex);
+}
+
+void Api550bAudioProcessor::updateLatency() noexcept
+{
+    const auto latency = getSaturatorLatency() + (linearPhaseActive ? linearPhaseEq.getLatencyInSamples() : 0);
+
+    if (latencySamples.exchange(latency, std::memory_order_relaxed) != latency)
+        triggerAsyncUpdate();
 }
 
-void Api550bAudioProcessor::parameterChanged(const juce::String&, float)
+void Api550bAudioProcessor::handleAsyncUpdate()
 {
-    parametersChanged = true;
+    const auto latency = latencySamples.load(std::memory_order_relaxed);
+
+    if (latency != getLatencySamples())
+        setLatencySamples(latency);
 }
 
-void Api550bAudioProcessor::updateFilters()
+void Api550bAudioProcessor::updateTailLength()
 {
-    parametersChanged = false;
-    double sampleRate = getSampleRate();
+    // Cascaded sections ring one after the other, so their decay times add up; with two band sets the longer one counts
+    const auto getDecaySamples = [this](bool secondSet)
+        {
+            const auto& bandSet = secondSet ? snapshot.secondBands : snapshot.bands;
+            double sum = 0.0;
+
+            for (int band = 0; band < CoefficientBank::numBands; ++band)
+            {
+                const auto& settings = bandSet[static_cast<size_t>(band)];
+                sum += getBandSection(band, secondSet).getDecaySamples();
 
-    static constexpr float lowFreqValues[] = { 40.f, 75.f, 150.f, 300.f, 600.f, 1200.f, 2400.f };
-    static constexpr float highFreqValues[] = { 800.f, 1500.f, 3000.f, 5000.f, 7000.f, 10000.f, 12500.f };
-    static constexpr float gainDbValues[] = { -12.f, -9.f, -6.f, -3.f, 0.f, 3.f, 6.f, 9.f, 12.f };
+                if (settings.mute && !settings.bypass)
+                    sum += CoefficientBank::numCutSections * getBandCut(band, secondSet).getDecaySamples();
+            }
 
-    auto getParamValue = [&](const juce::String& paramID, const float values[], size_t size) {
-        auto index = static_cast<size_t>(apvts.getRawParameterValue(paramID)->load());
-        return values[juce::jmin(index, size - 1)];
+            return sum;
         };
 
-    bool useProportionalQ = apvts.getRawParameterValue(Params::Q_MODE)->load() > 0.5f;
-    constexpr float fixedQ = 1.5f;
-
-    // Update saturation
-    Impl::saturationDrive = apvts.getRawParameterValue(Params::SAT_DRIVE)->load();
-    saturation.functionToUse = &Impl::applySaturation;
-
-    // Low Band
-    bool lowMute = apvts.getRawParameterValue(Params::LOW_MUTE)->load() > 0.5f;
-    bool lowBypass = apvts.getRawParameterValue(Params::LOW_BYPASS)->load() > 0.5f;
-    float lowFreq = getParamValue(Params::LOW_FREQ, lowFreqValues, std::size(lowFreqValues));
-    float lowGain = lowMute ? 0.0f : getParamValue(Params::LOW_GAIN, gainDbValues, std::size(gainDbValues));
-    float lowQ = useProportionalQ ? juce::jlimit(0.7f, 2.2f, 1.0f + 0.2f * std::abs(lowGain)) : fixedQ;
-    bool lowShelf = apvts.getRawParameterValue(Params::LOW_SHELF)->load() > 0.5f;
-    lowFilter.coefficients = lowBypass ? juce::dsp::IIR::Coefficients<float>::makeAllPass(sampleRate, lowFreq)
-        : lowShelf ? juce::dsp::IIR::Coefficients<float>::makeLowShelf(sampleRate, lowFreq, lowQ, juce::Decibels::decibelsToGain(lowGain))
-        : juce::dsp::IIR::Coefficients<float>::makePeakFilter(sampleRate, lowFreq, lowQ, juce::Decibels::decibelsToGain(lowGain));
-
-    // Low-Mid Band
-    bool lmMute = apvts.getRawParameterValue(Params::LM_MUTE)->load() > 0.5f;
-    bool lmBypass = apvts.getRawParameterValue(Params::LM_BYPASS)->load() > 0.5f;
-    float lmFreq = getParamValue(Params::LM_FREQ, lowFreqValues, std::size(lowFreqValues));
-    float lmGain = lmMute ? 0.0f : getParamValue(Params::LM_GAIN, gainDbValues, std::size(gainDbValues));
-    float lmQ = useProportionalQ ? juce::jlimit(0.7f, 2.2f, 1.0f + 0.2f * std::abs(lmGain)) : fixedQ;
-    lowMidFilter.coefficients = lmBypass ? juce::dsp::IIR::Coefficients<float>::makeAllPass(sampleRate, lmFreq)
-        : juce::dsp::IIR::Coefficients<float>::makePeakFilter(sampleRate, lmFreq, lmQ, juce::Decibels::decibelsToGain(lmGain));
-
-    // High-Mid Band
-    bool hmMute = apvts.getRawParameterValue(Params::HM_MUTE)->load() > 0.5f;
-    bool hmBypass = apvts.getRawParameterValue(Params::HM_BYPASS)->load() > 0.5f;
-    float hmFreq = getParamValue(Params::HM_FREQ, highFreqValues, std::size(highFreqValues));
-    float hmGain = hmMute ? 0.0f : getParamValue(Params::HM_GAIN, gainDbValues, std::size(gainDbValues));
-    float hmQ = useProportionalQ ? juce::jlimit(0.7f, 2.2f, 1.0f + 0.2f * std::abs(hmGain)) : fixedQ;
-    highMidFilter.coefficients = hmBypass ? juce::dsp::IIR::Coefficients<float>::makeAllPass(sampleRate, hmFreq)
-        : juce::dsp::IIR::Coefficients<float>::makePeakFilter(sampleRate, hmFreq, hmQ, juce::Decibels::decibelsToGain(hmGain));
-
-    // High Band
-    bool highMute = apvts.getRawParameterValue(Params::HIGH_MUTE)->load() > 0.5f;
-    bool highBypass = apvts.getRawParameterValue(Params::HIGH_BYPASS)->load() > 0.5f;
-    float highFreq = getParamValue(Params::HIGH_FREQ, highFreqValues, std::size(highFreqValues));
-    float highGain = highMute ? 0.0f : getParamValue(Params::HIGH_GAIN, gainDbValues, std::size(gainDbValues));
-    float highQ = useProportionalQ ? juce::jlimit(0.7f, 2.2f, 1.0f + 0.2f * std::abs(highGain)) : fixedQ;
-    bool highShelf = apvts.getRawParameterValue(Params::HIGH_SHELF)->load() > 0.5f;
-    highFilter.coefficients = highBypass ? juce::dsp::IIR::Coefficients<float>::makeAllPass(sampleRate, highFreq)
-        : highShelf ? juce::dsp::IIR::Coefficients<float>::makeHighShelf(sampleRate, highFreq * 1.3f, highQ, juce::Decibels::decibelsToGain(highGain))
-        : juce::dsp::IIR::Coefficients<float>::makePeakFilter(sampleRate, highFreq, highQ, juce::Decibels::decibelsToGain(highGain));
+    double samples = 0.0;
+
+    if (!linearPhaseActive)
+        samples = getDecaySamples(false);
+
+    if (!linearPhaseActive && secondSetChannels != 0)
+        samples = juce::jmax(samples, getDecaySamples(true));
+
+    if (linearPhaseActive)
+        samples = linearPhaseEq.getKernelLength();
+
+    samples += 2.0 * getSaturatorLatency(); // The oversampling filters hold on to a little too
+
+    tailSamples = static_cast<juce::int64>(std::ceil(samples));
+    tailLengthSeconds.store(samples / juce::jmax(1.0, coefficientBank.getSampleRate()), std::memory_order_relaxed);
+}
+
+template <typename SampleType>
+bool Api550bAudioProcessor::isChainIdle(const juce::AudioBuffer<SampleType>& buffer) noexcept
+{
+    constexpr auto silenceThreshold = static_cast<SampleType>(1.0e-6); // -120 dBFS
+    const auto numSamples = buffer.getNumSamples();
+
+    for (int ch = 0; ch < buffer.getNumChannels(); ++ch)
+    {
+        if (buffer.getMagnitude(ch, 0, numSamples) > silenceThreshold)
+        {
+            silentSamples = 0;
+            return false;
+        }
+    }
+
+    // Idle only if the tail had already died away before this block started
+    silentSamples += numSamples;
+    return silentSamples - numSamples >= tailSamples;
+}
+
+template <typename SampleType>
+void Api550bAudioProcessor::processLinearPhase(SampleType* const* channels, size_t numChannels, size_t numSamples) noexcept
+{
+    if constexpr (std::is_same_v<SampleType, float>)
+    {
+        linearPhaseEq.process(channels, numChannels, numSamples);
+    }
+    else
+    {
+        // The FIR itself is only float; its rounding noise sits far below the kernel's own truncation error
+        jassert(numSamples <= static_cast<size_t>(linearPhaseScratch.getNumSamples()));
+        numChannels = juce::jmin(numChannels, static_cast<size_t>(linearPhaseScratch.getNumChannels()));
+        numSamples = juce::jmin(numSamples, static_cast<size_t>(linearPhaseScratch.getNumSamples()));
+
+        auto* const* scratch = linearPhaseScratch.getArrayOfWritePointers();
+        for (size_t ch = 0; ch < numChannels; ++ch)
+            std::transform(channels[ch], channels[ch] + numSamples, scratch[ch], [](SampleType x) { return static_cast<float>(x); });
+
+        linearPhaseEq.process(scratch, numChannels, numSamples);
+
+        for (size_t ch = 0; ch < numChannels; ++ch)
+            std::transform(scratch[ch], scratch[ch] + numSamples, channels[ch], [](float x) { return static_cast<SampleType>(x); });
+    }
 }
 
 void Api550bAudioProcessor::processBlock(juce::AudioBuffer<float>& buffer, juce::MidiBuffer& /*midiMessages*/)
+{
+    processBlockImpl(buffer);
+}
+
+void Api550bAudioProcessor::processBlock(juce::AudioBuffer<double>& buffer, juce::MidiBuffer& /*midiMessages*/)
+{
+    processBlockImpl(buffer);
+}
+
+template <typename SampleType>
+void Api550bAudioProcessor::processBlockImpl(juce::AudioBuffer<SampleType>& buffer)
 {
     juce::ScopedNoDenormals noDenormals;
 
     if (buffer.getNumChannels() == 0 || getTotalNumInputChannels() != getTotalNumOutputChannels())
         return;
 
-    if (parametersChanged)
-        updateFilters();
+    EQALPHA_PROFILE_BLOCK(profiler, buffer.getNumSamples());
+
+    auto* const* channels = buffer.getArrayOfWritePointers();
+    const auto numChannels = juce::jmin(static_cast<size_t>(buffer.getNumChannels()), static_cast<size_t>(maxChannels));
+    const auto numSamples = static_cast<size_t>(buffer.getNumSamples());
+    auto& chain = getChain<SampleType>();
+
+    collectParameterChanges(numSamples);
+
+    EQALPHA_PROFILE_STAGE(parameters);
 
-    juce::dsp::AudioBlock<float> block(buffer);
-    juce::dsp::ProcessContextReplacing<float> context(block);
+    const auto feedAnalyser = analyserActive.load(std::memory_order_acquire); // Sees the FIFOs setAnalyserActive allocated
+    if (feedAnalyser)
+        preAnalyserFifo.push(channels, numChannels, numSamples);
 
-    if (!(apvts.getRawParameterValue(Params::LOW_BYPASS)->load() > 0.5f))
-        lowFilter.process(context);
-    if (!(apvts.getRawParameterValue(Params::LM_BYPASS)->load() > 0.5f))
-        lowMidFilter.process(context);
-    if (!(apvts.getRawParameterValue(Params::HM_BYPASS)->load() > 0.5f))
-        highMidFilter.process(context);
-    if (!(apvts.getRawParameterValue(Params::HIGH_BYPASS)->load() > 0.5f))
-        highFilter.process(context);
-    saturation.process(context);
+    EQALPHA_PROFILE_STAGE(analyser);
+
+    // The block is only split where a queued change lands, so a block without automation is still a single pass.
+    // The loop runs at least once, so an empty block still takes its changes.
+    const auto idle = isChainIdle(buffer);
+    std::array<SampleType*, maxChannels> segment{};
+
+    // The auto-gain meter compares against the input as it was before anything touched it
+    if (!idle)
+        autoGain.pushInput(channels, numChannels, numSamples);
+
+    size_t nextChange = 0, start = 0;
+
+    do
+    {
+        juce::uint32 flags = 0;
+        for (; nextChange < numPendingChanges && pendingChanges[nextChange].offset <= start; ++nextChange)
+        {
+            const auto& change = pendingChanges[nextChange];
+            stagedValues[static_cast<size_t>(change.index)].store(change.value, std::memory_order_relaxed);
+            flags |= change.flags;
+        }
+
+        if (flags != 0)
+        {
+            applyParameterChanges(flags);
+            EQALPHA_PROFILE_STAGE(parameters);
+        }
+
+        const auto end = nextChange < numPendingChanges ? pendingChanges[nextChange].offset : numSamples;
+        const auto num = end - start;
+
+        for (size_t ch = 0; ch < numChannels; ++ch)
+            segment[ch] = channels[ch] + start;
+
+        if (!idle && num > 0)
+        {
+            if (linearPhaseActive)
+                processLinearPhase(segment.data(), numChannels, num);
+            else if (dynamicBands != 0)
+                processDynamicFilters(segment.data(), numChannels, num);
+            else
+                chain.processFilters(segment.data(), numChannels, num);
+
+            EQALPHA_PROFILE_STAGE(filters);
+            chain.saturator.process(segment.data(), numChannels, num);
+            EQALPHA_PROFILE_STAGE(saturation);
+        }
+
+        start = end;
+    } while (start < numSamples);
+
+    numPendingChanges = 0;
+
+    autoGain.process(channels, numChannels, numSamples);
+    EQALPHA_PROFILE_STAGE(autoGain);
+
+    if (feedAnalyser)
+        postAnalyserFifo.push(channels, numChannels, numSamples);
+
+    EQALPHA_PROFILE_STAGE(analyser);
+}
+
+// JUCE doesn't pass on the host's sample offsets, so a change made from another thread (the editor, a host's
+// automation thread) is placed by when it arrived: its position within the previous block's interval becomes its
+// position in this block. Older changes, and those made on the audio thread itself just before the block, which is
+// how JUCE's VST3 wrapper delivers automation, land at the start. Offsets never go backwards, so changes keep their order.
+void Api550bAudioProcessor::collectParameterChanges(size_t numSamples) noexcept
+{
+    parameterEvents.setConsumerThread();
+
+    const auto now = juce::Time::getHighResolutionTicks();
+    const auto since = lastBlockTicks;
+    const auto interval = static_cast<double>(juce::jmax(static_cast<juce::int64>(1), now - since));
+    lastBlockTicks = now;
+
+    // A recall is being written: everything stays queued until its state can be taken whole
+    const auto sequence = recallSequence.load(std::memory_order_acquire);
+    if ((sequence & 1) != 0)
+        return;
+
+    auto flags = dirtyFlags.exchange(0, std::memory_order_acquire);
+    const auto recalled = sequence != appliedRecallSequence;
+
+    // Overflow or recall: everything queued is older than the values that are re-read now
+    if (flags != 0 || recalled)
+    {
+        ParameterEvent event;
+        while (parameterEvents.pop(event))
+            flags |= event.flags;
+
+        if (recalled)
+        {
+            for (size_t i = 0; i < hostValues.size(); ++i)
+                stagedValues[i].store(recallValues[i].load(std::memory_order_relaxed), std::memory_order_relaxed);
+
+            flags = DirtyFlags::all; // Every part switches in the same block
+        }
+        else
+        {
+            stageAllParameters();
+        }
+
+        // A recall started while the values were copied, so they may be half old and half new. Nothing reads the
+        // staged values until applyParameterChanges, so it is simply tried again next block.
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (recallSequence.load(std::memory_order_relaxed) != sequence)
+        {
+            dirtyFlags.fetch_or(flags, std::memory_order_relaxed);
+            return;
+        }
+
+        appliedRecallSequence = sequence;
+        applyParameterChanges(flags);
+        return;
+    }
+
+    ParameterEvent event;
+    size_t offset = 0;
+
+    while (numPendingChanges < pendingChanges.size() && parameterEvents.pop(event))
+    {
+        const auto position = static_cast<double>(juce::jlimit(static_cast<juce::int64>(0), now - since, event.ticks - since)) / interval;
+        offset = juce::jmax(offset, juce::jmin(static_cast<size_t>(position * static_cast<double>(numSamples)), numSamples > 0 ? numSamples - 1 : 0));
+        pendingChanges[numPendingChanges++] = { event.index, event.flags, event.value, offset };
+    }
+}
+
+void Api550bAudioProcessor::stageAllParameters() noexcept
+{
+    for (size_t i = 0; i < hostValues.size(); ++i)
+        if (hostValues[i] != nullptr)
+            stagedValues[i].store(hostValues[i]->load(std::memory_order_relaxed), std::memory_order_relaxed);
+}
+
+// A dynamic band moves from flat towards its GAIN setting as its envelope rises above the threshold, reaching it
+// once the envelope is |gain| * ratio / (ratio - 1) dB over. A cut makes it a compressor for that band, a boost
+// an upward expander.
+BiquadCoefficients Api550bAudioProcessor::getDynamicSection(int band) const noexcept
+{
+    const auto& settings = snapshot.bands[static_cast<size_t>(band)];
+    const auto& dynamics = snapshot.dynamics[static_cast<size_t>(band)];
+    const auto targetDb = snapshot.continuous ? snapshot.continuousBands[static_cast<size_t>(band)].gainDb
+                                              : EqTables::gainDbValues[juce::jlimit(0, EqTables::numGains - 1, settings.gainIndex)];
+
+    if (targetDb == 0.0f)
+        return {};
+
+    const auto overDb = juce::jmax(0.0f, bandDetector.getLevelDb(band) - dynamics.thresholdDb);
+    const auto depth = juce::jmin(1.0f, overDb * (1.0f - 1.0f / juce::jmax(1.0f, dynamics.ratio)) / std::abs(targetDb));
+    if (snapshot.continuous)
+        return continuousTable.get(band, snapshot.continuousBands[static_cast<size_t>(band)].freqHz, targetDb * depth, settings.shelf, snapshot.proportionalQ);
+
+    return coefficientBank.getInterpolated(band, settings.freqIndex, targetDb * depth, settings.shelf, snapshot.proportionalQ);
+}
+
+// Runs the filters a sub-block at a time, so every dynamic band can be retargeted in between.
+// The detector listens to the input, before the bands have touched it.
+template <typename SampleType>
+void Api550bAudioProcessor::processDynamicFilters(SampleType* const* channels, size_t numChannels, size_t numSamples) noexcept
+{
+    auto& chain = getChain<SampleType>();
+    std::array<SampleType*, maxChannels> subBlock{};
+    numChannels = juce::jmin(numChannels, static_cast<size_t>(maxChannels));
+
+    for (size_t start = 0; start < numSamples; start += dynamicsSubBlockSize)
+    {
+        const auto num = juce::jmin(dynamicsSubBlockSize, numSamples - start);
+        bandDetector.process(channels, numChannels, start, num);
+
+        for (int band = 0; band < CoefficientBank::numBands; ++band)
+            if ((dynamicBands & (1u << band)) != 0)
+                chain.eqCascade.glideToCoefficients(static_cast<size_t>(band), getDynamicSection(band), 1);
+
+        for (size_t ch = 0; ch < numChannels; ++ch)
+            subBlock[ch] = channels[ch] + start;
+
+        chain.processFilters(subBlock.data(), numChannels, num);
+    }
+}
+
+// Holds the audio thread off for the length of a recall, then publishes the parameters' values as one state
+class Api550bAudioProcessor::ScopedRecall
+{
+public:
+    explicit ScopedRecall(Api550bAudioProcessor& p)
+        : processor(p), lock(p.recallLock)
+    {
+        processor.parameterListener.setRecallThread(juce::Thread::getCurrentThreadId());
+        processor.recallSequence.store(processor.recallSequence.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+    }
+
+    ~ScopedRecall()
+    {
+        for (size_t i = 0; i < processor.hostValues.size(); ++i)
+            if (processor.hostValues[i] != nullptr)
+                processor.recallValues[i].store(processor.hostValues[i]->load(std::memory_order_relaxed), std::memory_order_relaxed);
+
+        processor.recallSequence.store(processor.recallSequence.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+        processor.parameterListener.setRecallThread(nullptr);
+    }
+
+private:
+    Api550bAudioProcessor& processor;
+    const juce::ScopedLock lock; // Recalls from different threads take turns
+
+    JUCE_DECLARE_NON_COPYABLE(ScopedRecall)
+};
+
+void Api550bAudioProcessor::applyPackedState(const PackedState& state)
+{
+    auto set = [this](const juce::String* id, float value) {
+        if (id != nullptr)
+            if (auto* parameter = apvts.getParameter(*id))
+                parameter->setValueNotifyingHost(parameter->convertTo0to1(value));
+        };
+
+    const ScopedRecall recall(*this);
+
+    for (size_t band = 0; band < bandParameterIDs.size(); ++band)
+    {
+        const auto& ids = bandParameterIDs[band];
+        const auto& b = state.bands[band];
+        set(ids.freq, b.freqIndex);
+        set(ids.gain, b.gainIndex);
+        set(ids.shelf, (b.flags & PackedState::shelf) != 0 ? 1.0f : 0.0f);
+        set(ids.mute, (b.flags & PackedState::mute) != 0 ? 1.0f : 0.0f);
+        set(ids.bypass, (b.flags & PackedState::bypass) != 0 ? 1.0f : 0.0f);
+
+        const auto& dyn = state.dynamics[band];
+        set(ids.dynamic, (b.flags & PackedState::dynamic) != 0 ? 1.0f : 0.0f);
+        set(ids.threshold, dyn.thresholdDb);
+        set(ids.ratio, dyn.ratio);
+        set(ids.attack, dyn.attackMs);
+        set(ids.release, dyn.releaseMs);
+
+        set(ids.continuousFreq, state.continuousBands[band].freqHz);
+        set(ids.continuousGain, state.continuousBands[band].gainDb);
+
+        const auto& secondIds = secondBandParameterIDs[band];
+        const auto& second = state.secondBands[band];
+        set(secondIds.freq, second.freqIndex);
+        set(secondIds.gain, second.gainIndex);
+        set(secondIds.shelf, (second.flags & PackedState::shelf) != 0 ? 1.0f : 0.0f);
+        set(secondIds.mute, (second.flags & PackedState::mute) != 0 ? 1.0f : 0.0f);
+        set(secondIds.bypass, (second.flags & PackedState::bypass) != 0 ? 1.0f : 0.0f);
+    }
+
+    set(&Params::Q_MODE, state.proportionalQ);
+    set(&Params::MUTE_CUT, state.cutLevelIndex);
+    set(&Params::SAT_OVERSAMPLING, state.oversamplingIndex);
+    set(&Params::PHASE_MODE, state.linearPhase);
+    set(&Params::SAT_DRIVE, state.drive);
+    set(&Params::STEREO_MODE, state.stereoMode);
+    set(&Params::SAT_DRIVE_B, state.secondDrive);
+    set(&Params::CONTINUOUS, state.continuous);
+}
+
+void Api550bAudioProcessor::selectSnapshot(int slot)
+{
+    slot = juce::jlimit(0, numSnapshotSlots - 1, slot);
+    const juce::ScopedLock sl(recallLock);
+    const auto previous = activeSnapshot.load(std::memory_order_relaxed);
+    if (slot == previous)
+        return;
+
+    snapshotSlots[static_cast<size_t>(previous)] = PackedState::capture(parameterPointers);
+    activeSnapshot.store(slot, std::memory_order_relaxed);
+    applyPackedState(snapshotSlots[static_cast<size_t>(slot)]);
+}
+
+void Api550bAudioProcessor::setCurrentProgram(int index)
+{
+    const auto& programs = FactoryPrograms::getPrograms();
+    if (!juce::isPositiveAndBelow(index, static_cast<int>(programs.size())))
+        return;
+
+    currentProgram = index;
+    applyPackedState(programs[static_cast<size_t>(index)].state);
+}
+
+const juce::String Api550bAudioProcessor::getProgramName(int index)
+{
+    const auto& programs = FactoryPrograms::getPrograms();
+    return juce::isPositiveAndBelow(index, static_cast<int>(programs.size())) ? programs[static_cast<size_t>(index)].name : juce::String();
 }
 
 void Api550bAudioProcessor::getStateInformation(juce::MemoryBlock& destData)
 {
-    auto state = apvts.copyState();
-    std::unique_ptr<juce::XmlElement> xml(state.createXml());
-    copyXmlToBinary(*xml, destData);
+    juce::MemoryOutputStream stream(destData, false);
+    stream.writeInt(static_cast<int>(stateMagic));
+    stream.writeShort(static_cast<short>(stateVersion));
+
+    const auto& descriptions = ParameterLayout::getDescriptions();
+    stream.writeShort(static_cast<short>(rangedParameters.size()));
+    for (size_t i = 0; i < rangedParameters.size(); ++i)
+    {
+        stream.writeInt(static_cast<int>(descriptions[i].hash));
+        stream.writeFloat(rangedParameters[i]->convertFrom0to1(rangedParameters[i]->getValue()));
+    }
+
+    const juce::ScopedLock sl(recallLock);
+    stream.writeByte(static_cast<char>(activeSnapshot.load(std::memory_order_relaxed)));
+    stream.writeByte(static_cast<char>(numSnapshotSlots));
+    // One section per version, each written for all slots before the next, so older readers stop where they must
+    for (int section = 0; section < PackedStateSections::numSections; ++section)
+    {
+        const auto begin = section > 0 ? PackedStateSections::ends[section - 1] : 0;
+        for (const auto& slot : snapshotSlots)
+            stream.write(reinterpret_cast<const char*>(&slot) + begin, PackedStateSections::ends[section] - begin);
+    }
+}
+
+bool Api550bAudioProcessor::setBinaryState(const void* data, int sizeInBytes)
+{
+    juce::MemoryInputStream stream(data, static_cast<size_t>(sizeInBytes), false);
+
+    if (sizeInBytes < 8 || static_cast<juce::uint32>(stream.readInt()) != stateMagic)
+        return false;
+
+    // Newer versions may only append, so anything this version knows how to read is still read
+    const auto version = stream.readShort();
+    if (version < 1)
+        return false;
+
+    const ScopedRecall recall(*this);
+
+    std::vector<float> storedValues(rangedParameters.size(), std::numeric_limits<float>::quiet_NaN()); // NaN: not in the blob
+    const auto numParameters = static_cast<juce::uint16>(stream.readShort());
+    for (int i = 0; i < numParameters && stream.getNumBytesRemaining() >= 8; ++i)
+    {
+        const auto hash = static_cast<juce::uint32>(stream.readInt());
+        const auto value = stream.readFloat();
+
+        if (const auto index = ParameterLayout::findIndex(hash); index >= 0)
+            storedValues[static_cast<size_t>(index)] = rangedParameters[static_cast<size_t>(index)]->convertTo0to1(value);
+    }
+
+    // Parameters newer than the blob go back to their defaults, as they do when replaceState loads an XML session.
+    // Most of a session's parameters sit at their defaults; only the ones that move notify the host and the DSP.
+    for (size_t i = 0; i < rangedParameters.size(); ++i)
+    {
+        auto* parameter = rangedParameters[i];
+        const auto normalised = std::isnan(storedValues[i]) ? parameter->getDefaultValue() : storedValues[i];
+        if (normalised != parameter->getValue())
+            parameter->setValueNotifyingHost(normalised);
+    }
+
+    const auto savedActive = static_cast<int>(stream.readByte());
+    const auto numSlots = juce::jmin(static_cast<int>(static_cast<juce::uint8>(stream.readByte())), numSnapshotSlots);
+    snapshotSlots.fill(PackedState::capture(parameterPointers));
+
+    // Sections newer than the saved version keep the values of the current state
+    for (int section = 0; section < juce::jmin(static_cast<int>(version), PackedStateSections::numSections); ++section)
+    {
+        const auto begin = section > 0 ? PackedStateSections::ends[section - 1] : 0;
+        const auto size = PackedStateSections::ends[section] - begin;
+
+        for (int i = 0; i < numSlots && stream.getNumBytesRemaining() >= static_cast<juce::int64>(size); ++i)
+            stream.read(reinterpret_cast<char*>(&snapshotSlots[static_cast<size_t>(i)]) + begin, static_cast<int>(size));
+    }
+
+    activeSnapshot.store(juce::jlimit(0, numSnapshotSlots - 1, savedActive), std::memory_order_relaxed);
+    return true;
 }
 
 void Api550bAudioProcessor::setStateInformation(const void* data, int sizeInBytes)
 {
+    if (setBinaryState(data, sizeInBytes))
+        return;
+
+    // Sessions saved before the binary format hold the APVTS state as XML
     std::unique_ptr<juce::XmlElement> xmlState(getXmlFromBinary(data, sizeInBytes));
     if (xmlState != nullptr)
+    {
         if (xmlState->hasTagName(apvts.state.getType()))
+        {
+            const ScopedRecall recall(*this);
             apvts.replaceState(juce::ValueTree::fromXml(*xmlState));
+            snapshotSlots.fill(PackedState::capture(parameterPointers));
+            activeSnapshot.store(0, std::memory_order_relaxed);
+        }
+    }
+}
+
+void Api550bAudioProcessor::setAnalyserActive(bool shouldBeActive)
+{
+    // Instances whose editor never opens never carry the FIFOs
+    if (shouldBeActive)
+    {
+        preAnalyserFifo.allocate();
+        postAnalyserFifo.allocate();
+    }
+
+    analyserActive.store(shouldBeActive, std::memory_order_release);
 }
 
 juce::AudioProcessorEditor* Api550bAudioProcessor::createEditor()
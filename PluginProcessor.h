@@ -1,6 +1,18 @@
 #pragma once
 #include <JuceHeader.h>
+#include <array>
 #include <atomic>
+#include "CoefficientBank.h"
+#include "ContinuousCoefficientTable.h"
+#include "ProcessingChain.h"
+#include "ParameterSnapshot.h"
+#include "AnalyserFifo.h"
+#include "LinearPhaseEq.h"
+#include "BandDetector.h"
+#include "AutoGain.h"
+#include "PackedState.h"
+#include "ParameterLayout.h"
+#include "StageProfiler.h"
 
 namespace Params
 {
@@ -23,19 +35,90 @@ namespace Params
     inline const juce::String HIGH_MUTE{ "HIGH_MUTE" }; // New: Mute for High band
     inline const juce::String HIGH_BYPASS{ "HIGH_BYPASS" }; // New: Bypass for High band
     inline const juce::String SAT_DRIVE{ "SAT_DRIVE" };
+    inline const juce::String SAT_OVERSAMPLING{ "SAT_OVERSAMPLING" };
     inline const juce::String Q_MODE{ "Q_MODE" };
+    inline const juce::String MUTE_CUT{ "MUTE_CUT" }; // How deep a muted band cuts
+    inline const juce::String PHASE_MODE{ "PHASE_MODE" }; // Minimum (IIR, no latency) or linear (FIR)
+
+    inline const juce::String STEREO_MODE{ "STEREO_MODE" }; // Linked, dual mono or mid/side
+    inline const juce::String SAT_DRIVE_B{ "SAT_DRIVE_B" }; // Right or side drive
+
+    // Second band set, for the right or side channel
+    inline const juce::String LOW_FREQ_B{ "LOW_FREQ_B" };
+    inline const juce::String LOW_GAIN_B{ "LOW_GAIN_B" };
+    inline const juce::String LOW_SHELF_B{ "LOW_SHELF_B" };
+    inline const juce::String LOW_MUTE_B{ "LOW_MUTE_B" };
+    inline const juce::String LOW_BYPASS_B{ "LOW_BYPASS_B" };
+    inline const juce::String LM_FREQ_B{ "LM_FREQ_B" };
+    inline const juce::String LM_GAIN_B{ "LM_GAIN_B" };
+    inline const juce::String LM_MUTE_B{ "LM_MUTE_B" };
+    inline const juce::String LM_BYPASS_B{ "LM_BYPASS_B" };
+    inline const juce::String HM_FREQ_B{ "HM_FREQ_B" };
+    inline const juce::String HM_GAIN_B{ "HM_GAIN_B" };
+    inline const juce::String HM_MUTE_B{ "HM_MUTE_B" };
+    inline const juce::String HM_BYPASS_B{ "HM_BYPASS_B" };
+    inline const juce::String HIGH_FREQ_B{ "HIGH_FREQ_B" };
+    inline const juce::String HIGH_GAIN_B{ "HIGH_GAIN_B" };
+    inline const juce::String HIGH_SHELF_B{ "HIGH_SHELF_B" };
+    inline const juce::String HIGH_MUTE_B{ "HIGH_MUTE_B" };
+    inline const juce::String HIGH_BYPASS_B{ "HIGH_BYPASS_B" };
+
+    // Dynamic mode per band: the band's gain follows its own band-limited envelope
+    inline const juce::String LOW_DYN{ "LOW_DYN" };
+    inline const juce::String LOW_THRESHOLD{ "LOW_THRESHOLD" };
+    inline const juce::String LOW_RATIO{ "LOW_RATIO" };
+    inline const juce::String LOW_ATTACK{ "LOW_ATTACK" };
+    inline const juce::String LOW_RELEASE{ "LOW_RELEASE" };
+    inline const juce::String LM_DYN{ "LM_DYN" };
+    inline const juce::String LM_THRESHOLD{ "LM_THRESHOLD" };
+    inline const juce::String LM_RATIO{ "LM_RATIO" };
+    inline const juce::String LM_ATTACK{ "LM_ATTACK" };
+    inline const juce::String LM_RELEASE{ "LM_RELEASE" };
+    inline const juce::String HM_DYN{ "HM_DYN" };
+    inline const juce::String HM_THRESHOLD{ "HM_THRESHOLD" };
+    inline const juce::String HM_RATIO{ "HM_RATIO" };
+    inline const juce::String HM_ATTACK{ "HM_ATTACK" };
+    inline const juce::String HM_RELEASE{ "HM_RELEASE" };
+    inline const juce::String HIGH_DYN{ "HIGH_DYN" };
+    inline const juce::String HIGH_THRESHOLD{ "HIGH_THRESHOLD" };
+    inline const juce::String HIGH_RATIO{ "HIGH_RATIO" };
+    inline const juce::String HIGH_ATTACK{ "HIGH_ATTACK" };
+    inline const juce::String HIGH_RELEASE{ "HIGH_RELEASE" };
+
+    // Continuous mode: the first band set takes its frequency and gain from these instead of the steps
+    inline const juce::String CONTINUOUS{ "CONTINUOUS" };
+    inline const juce::String LOW_FREQ_C{ "LOW_FREQ_C" };
+    inline const juce::String LOW_GAIN_C{ "LOW_GAIN_C" };
+    inline const juce::String LM_FREQ_C{ "LM_FREQ_C" };
+    inline const juce::String LM_GAIN_C{ "LM_GAIN_C" };
+    inline const juce::String HM_FREQ_C{ "HM_FREQ_C" };
+    inline const juce::String HM_GAIN_C{ "HM_GAIN_C" };
+    inline const juce::String HIGH_FREQ_C{ "HIGH_FREQ_C" };
+    inline const juce::String HIGH_GAIN_C{ "HIGH_GAIN_C" };
+
+    inline const juce::String AUTO_GAIN{ "AUTO_GAIN" }; // Matches the output's loudness to the input's
+
+    // Channel link: off, every channel runs the band set its own choice picks instead of the first set
+    inline const juce::String CHANNEL_LINK{ "CHANNEL_LINK" };
+    inline const std::array<juce::String, ParameterPointers::maxChannels> CHANNEL_SETS{ "CH1_SET", "CH2_SET", "CH3_SET", "CH4_SET",
+        "CH5_SET", "CH6_SET", "CH7_SET", "CH8_SET", "CH9_SET", "CH10_SET", "CH11_SET", "CH12_SET", "CH13_SET", "CH14_SET", "CH15_SET", "CH16_SET" };
 }
 
-class Api550bAudioProcessor : public juce::AudioProcessor,
-    private juce::AudioProcessorValueTreeState::Listener
+class Api550bAudioProcessor : public juce::AudioProcessor, private juce::AsyncUpdater
 {
 public:
     Api550bAudioProcessor();
-    ~Api550bAudioProcessor() override = default;
+    ~Api550bAudioProcessor() override;
+
+    static constexpr int maxChannels = 16;
+    static_assert(maxChannels == static_cast<int>(ParameterPointers::maxChannels), "Every channel needs its band set choice");
 
     void prepareToPlay(double sampleRate, int samplesPerBlock) override;
     void releaseResources() override {}
     void processBlock(juce::AudioBuffer<float>& buffer, juce::MidiBuffer& midiMessages) override;
+    void processBlock(juce::AudioBuffer<double>& buffer, juce::MidiBuffer& midiMessages) override;
+    bool supportsDoublePrecisionProcessing() const override { return true; }
+    bool isBusesLayoutSupported(const BusesLayout& layouts) const override;
 
     juce::AudioProcessorEditor* createEditor() override;
     bool hasEditor() const override { return true; }
@@ -44,40 +127,173 @@ public:
     bool acceptsMidi() const override { return false; }
     bool producesMidi() const override { return false; }
     bool isMidiEffect() const override { return false; }
-    double getTailLengthSeconds() const override { return 0.0; }
+    double getTailLengthSeconds() const override { return tailLengthSeconds.load(std::memory_order_relaxed); }
 
-    int getNumPrograms() override { return 1; }
-    int getCurrentProgram() override { return 0; }
-    void setCurrentProgram(int) override {}
-    const juce::String getProgramName(int) override { return {}; }
+    int getNumPrograms() override { return static_cast<int>(FactoryPrograms::getPrograms().size()); }
+    int getCurrentProgram() override { return currentProgram; }
+    void setCurrentProgram(int index) override;
+    const juce::String getProgramName(int index) override;
     void changeProgramName(int, const juce::String&) override {}
 
     void getStateInformation(juce::MemoryBlock& destData) override;
     void setStateInformation(const void* data, int sizeInBytes) override;
 
+    // Creates the parameters from ParameterLayout's shared descriptions
     static juce::AudioProcessorValueTreeState::ParameterLayout createParameterLayout();
 
     juce::AudioProcessorValueTreeState apvts;
 
+    // Analyser feeds for the editor; only written while an editor has switched them on
+    AnalyserFifo& getPreAnalyserFifo() noexcept { return preAnalyserFifo; }
+    AnalyserFifo& getPostAnalyserFifo() noexcept { return postAnalyserFifo; }
+    void setAnalyserActive(bool shouldBeActive); // Message thread; the first call allocates the FIFOs
+
+    const ParameterPointers& getParameterPointers() const noexcept { return parameterPointers; }
+
+    // Loudness readings and the gain they lead to; atomics, so the editor can poll them
+    const AutoGain& getAutoGain() const noexcept { return autoGain; }
+
+#if EQALPHA_PROFILING
+    const StageProfiler& getProfiler() const noexcept { return profiler; }
+    void setProfilerDeadlineFraction(double fraction) noexcept { profiler.setDeadlineFraction(fraction); }
+#endif
+
+    // A/B/C/D comparison: the active slot follows the current edits, selecting another one stores
+    // the current state in the active slot and recalls the other. The slots are shared with session loads, which a
+    // host may run on another thread, so they are guarded by the recall lock; the editor polls the active slot.
+    static constexpr int numSnapshotSlots = 4;
+    void selectSnapshot(int slot);
+    int getActiveSnapshot() const noexcept { return activeSnapshot.load(std::memory_order_relaxed); }
+
 private:
-    class Impl
+    CoefficientBank coefficientBank; // Rebuilt in prepareToPlay, read-only on the audio thread
+    ContinuousCoefficientTable continuousTable; // Same, for continuous mode
+
+    // A band's section, frequency and mute cut from the bank, or from the table in continuous mode (first set only)
+    BiquadCoefficients getBandSection(int band, bool secondSet) const noexcept;
+    BiquadCoefficients getBandCut(int band, bool secondSet) const noexcept;
+    float getBandFrequency(int band) const noexcept;
+
+    // Float runs its bands as state-variable filters, which keep low bands precise at high sample rates;
+    // double has the headroom for the cheaper transposed direct form II
+    ProcessingChain<float, StateVariableFilter> floatChain;
+    ProcessingChain<double, TransposedDirectFormII> doubleChain;
+    static_assert(decltype(floatChain.eqCascade)::maxNumChannels >= maxChannels && decltype(doubleChain.eqCascade)::maxNumChannels >= maxChannels);
+
+    template <typename SampleType>
+    auto& getChain() noexcept
+    {
+        if constexpr (std::is_same_v<SampleType, float>)
+            return floatChain;
+        else
+            return doubleChain;
+    }
+
+    template <typename Fn>
+    void forEachChain(Fn&& fn) { fn(floatChain); fn(doubleChain); }
+
+    int getSaturatorLatency() const noexcept
     {
-    public:
-        static float applySaturation(float x)
-        {
-            // Avoid division by zero by clamping saturationDrive away from 0
-            return saturationDrive > 0.001f ? std::tanh(saturationDrive * x) / saturationDrive : x;
-        }
-
-        static float saturationDrive;
+        return isUsingDoublePrecision() ? doubleChain.saturator.getLatencyInSamples() : floatChain.saturator.getLatencyInSamples();
+    }
+
+    // Dynamic bands: retargeted once per sub-block from their detector, with the section interpolated on the
+    // bank's gain grid, or looked up in the continuous table. Linear-phase mode is static and ignores them.
+    static constexpr size_t dynamicsSubBlockSize = 32;
+    BandDetector bandDetector;
+    juce::uint32 dynamicBands = 0; // One bit per band in dynamic mode
+    BiquadCoefficients getDynamicSection(int band) const noexcept;
+    template <typename SampleType>
+    void processDynamicFilters(SampleType* const* channels, size_t numChannels, size_t numSamples) noexcept;
+
+    // Runs after the saturator. Not part of the A/B slots, so every slot is heard at the input's loudness.
+    AutoGain autoGain;
+    static_assert(AutoGain::maxChannels >= maxChannels);
+
+    LinearPhaseEq linearPhaseEq; // Replaces the cascade and the cuts in linear-phase mode
+    bool linearPhaseActive = false;
+    StereoMode activeStereoMode = StereoMode::linked; // What the chains run in; falls back to linked off stereo buses
+    juce::uint32 secondSetChannels = 0; // One bit per channel that runs the second band set; none when linked
+    juce::AudioBuffer<float> linearPhaseScratch; // The convolution is float only, double blocks go through here
+
+    ParameterPointers parameterPointers; // The APVTS values, for the message thread; cached once, so nothing looks an ID up
+    ParameterSnapshot snapshot;
+
+    // Sample-accurate automation: changes are queued with their arrival time, and the audio thread reads its own
+    // staged copy of every value, which only moves when a queued change reaches its offset in the block. The
+    // DSP reads stagedPointers, laid out like parameterPointers but pointing into stagedValues.
+    ParameterEventQueue parameterEvents;
+    std::vector<std::atomic<float>*> hostValues; // APVTS values by parameter index
+    std::unique_ptr<std::atomic<float>[]> stagedValues;
+    ParameterPointers stagedPointers;
+
+    struct PendingChange
+    {
+        int index;
+        juce::uint32 flags;
+        float value;
+        size_t offset;
     };
 
-    juce::dsp::IIR::Filter<float> lowFilter, lowMidFilter, highMidFilter, highFilter;
-    juce::dsp::WaveShaper<float> saturation;
+    std::array<PendingChange, ParameterEventQueue::capacity> pendingChanges;
+    size_t numPendingChanges = 0;
+    juce::int64 lastBlockTicks = 0;
+    void collectParameterChanges(size_t numSamples) noexcept;
+    void stageAllParameters() noexcept;
+
+    // Parts to re-read wholesale at the start of the next block: set on a queue overflow and after a recall
+    std::atomic<juce::uint32> dirtyFlags{ DirtyFlags::all };
+    ParameterChangeListener parameterListener{ parameterEvents, dirtyFlags }; // Hears every parameter through the processor
+
+    template <typename SampleType>
+    void processBlockImpl(juce::AudioBuffer<SampleType>& buffer);
+    template <typename SampleType>
+    void processLinearPhase(SampleType* const* channels, size_t numChannels, size_t numSamples) noexcept;
+
+    void applyParameterChanges(juce::uint32 flags);
+
+    // setLatencySamples tells the host synchronously, which is not for the audio thread: a change made there is
+    // reported from the message thread, one made in prepareToPlay straight away
+    void updateLatency() noexcept;
+    void handleAsyncUpdate() override;
+    std::atomic<int> latencySamples{ 0 };
+
+    // Silent-input fast path: once the input has been silent for longer than the filters ring,
+    // the whole chain is skipped until signal comes back
+    void updateTailLength();
+    template <typename SampleType>
+    bool isChainIdle(const juce::AudioBuffer<SampleType>& buffer) noexcept;
+    std::atomic<double> tailLengthSeconds{ 0.0 };
+    juce::int64 tailSamples = 0, silentSamples = 0;
+
+    AnalyserFifo preAnalyserFifo, postAnalyserFifo;
+    std::atomic<bool> analyserActive{ false };
+
+#if EQALPHA_PROFILING
+    StageProfiler profiler;
+#endif
+
+    // A recall (snapshot slot, program or session) writes every parameter, then hands the audio thread the whole state
+    // in one step through a sequence lock: recallSequence is odd while a recall is being written, and a copy the audio
+    // thread made while it moved is thrown away. Until a new even value shows up the queued changes stay queued, so a
+    // half-written state is never applied. Parameter changes made by the recalling thread itself aren't queued.
+    class ScopedRecall;
+    juce::CriticalSection recallLock; // Writers only, the audio thread never takes it; also guards the snapshot slots
+    std::atomic<juce::uint32> recallSequence{ 0 };
+    juce::uint32 appliedRecallSequence = 0; // Audio thread
+    std::unique_ptr<std::atomic<float>[]> recallValues; // By parameter index
+    void applyPackedState(const PackedState& state);
+
+    std::array<PackedState, numSnapshotSlots> snapshotSlots;
+    std::atomic<int> activeSnapshot{ 0 };
+    int currentProgram = 0;
 
-    std::atomic<bool> parametersChanged{ true };
-    void parameterChanged(const juce::String& parameterID, float newValue) override;
-    void updateFilters();
+    // Binary session format: magic, version, then (hashed parameter ID, value) pairs and the snapshot slots.
+    // Hashed IDs keep old sessions loadable when parameters are added, removed or reordered.
+    static constexpr juce::uint32 stateMagic = 0x33415145; // "EQA3"
+    static constexpr int stateVersion = 4; // 2 appends the slots' dynamics, 3 their second band set and stereo mode, 4 continuous mode
+    std::vector<juce::RangedAudioParameter*> rangedParameters; // By index; ParameterLayout maps the hashes to indices
+    bool setBinaryState(const void* data, int sizeInBytes);
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(Api550bAudioProcessor)
 };
\ No newline at end of file
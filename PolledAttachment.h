@@ -0,0 +1,154 @@
+#pragma once
+#include <JuceHeader.h>
+#include <algorithm>
+#include <functional>
+#include <limits>
+#include <vector>
+
+// Binds a slider, button or combo box to a parameter, like the APVTS attachments, but without a parameter listener.
+// The group's timer copies parameter values into the controls, so a burst of automation costs one comparison per
+// control per tick, and each control repaints at most once per tick, instead of an async message and a repaint per
+// change. Control edits still go straight to the parameter, with a change gesture around them.
+class PolledAttachment : private juce::Slider::Listener, private juce::Button::Listener, private juce::ComboBox::Listener
+{
+public:
+    class Group : private juce::Timer
+    {
+    public:
+        Group() { startTimerHz(30); }
+        ~Group() override { jassert(attachments.empty()); } // Attachments must go first, declare the group before them
+
+        // Called after a tick that moved any control. Controls are refreshed without notifying, so anything that
+        // depends on their values (and may create or destroy attachments) is updated from here, once the loop is done.
+        std::function<void()> onRefresh;
+
+    private:
+        friend class PolledAttachment;
+
+        void timerCallback() override
+        {
+            auto changed = false;
+            for (auto* attachment : attachments)
+                changed = attachment->refresh() || changed;
+
+            if (changed && onRefresh != nullptr)
+                onRefresh();
+        }
+
+        std::vector<PolledAttachment*> attachments;
+
+        JUCE_DECLARE_NON_COPYABLE(Group)
+    };
+
+    PolledAttachment(Group& g, juce::AudioProcessorValueTreeState& state, const juce::String& parameterID, juce::Slider& s)
+        : PolledAttachment(g, state, parameterID)
+    {
+        slider = &s;
+
+        auto range = parameter.getNormalisableRange();
+        juce::NormalisableRange<double> sliderRange{ static_cast<double>(range.start), static_cast<double>(range.end),
+            [range](double, double, double normalised) { return static_cast<double>(range.convertFrom0to1(static_cast<float>(normalised))); },
+            [range](double, double, double value) { return static_cast<double>(range.convertTo0to1(static_cast<float>(value))); },
+            [range](double, double, double value) { return static_cast<double>(range.snapToLegalValue(static_cast<float>(value))); } };
+        sliderRange.interval = range.interval;
+        sliderRange.skew = range.skew;
+        sliderRange.symmetricSkew = range.symmetricSkew;
+
+        auto& p = parameter;
+        slider->valueFromTextFunction = [&p](const juce::String& text) { return static_cast<double>(p.convertFrom0to1(p.getValueForText(text))); };
+        slider->textFromValueFunction = [&p](double value) { return p.getText(p.convertTo0to1(static_cast<float>(value)), 0); };
+        slider->setNormalisableRange(sliderRange);
+        slider->setDoubleClickReturnValue(true, static_cast<double>(range.convertFrom0to1(parameter.getDefaultValue())));
+        slider->addListener(this);
+        refresh();
+    }
+
+    PolledAttachment(Group& g, juce::AudioProcessorValueTreeState& state, const juce::String& parameterID, juce::Button& b)
+        : PolledAttachment(g, state, parameterID)
+    {
+        button = &b;
+        button->addListener(this);
+        refresh();
+    }
+
+    // Items are expected to use IDs 1..n in the parameter's order, as ComboBox::addItemList(list, 1) gives
+    PolledAttachment(Group& g, juce::AudioProcessorValueTreeState& state, const juce::String& parameterID, juce::ComboBox& c)
+        : PolledAttachment(g, state, parameterID)
+    {
+        comboBox = &c;
+        comboBox->addListener(this);
+        refresh();
+    }
+
+    ~PolledAttachment() override
+    {
+        if (slider != nullptr)
+            slider->removeListener(this);
+        if (button != nullptr)
+            button->removeListener(this);
+        if (comboBox != nullptr)
+            comboBox->removeListener(this);
+
+        auto& list = group.attachments;
+        list.erase(std::remove(list.begin(), list.end(), this), list.end());
+    }
+
+    // Called by the group's timer; only touches the control when the parameter moved since the last tick.
+    // Never notifies, so no control callback can change the group's list while it is being walked.
+    bool refresh()
+    {
+        const auto value = parameter.convertFrom0to1(parameter.getValue());
+        if (value == lastValue)
+            return false;
+
+        lastValue = value;
+        const juce::ScopedValueSetter<bool> svs(updatingControl, true);
+
+        if (slider != nullptr)
+            slider->setValue(value, juce::dontSendNotification);
+        else if (button != nullptr)
+            button->setToggleState(value >= 0.5f, juce::dontSendNotification);
+        else if (comboBox != nullptr)
+            comboBox->setSelectedItemIndex(juce::roundToInt(value), juce::dontSendNotification);
+
+        return true;
+    }
+
+private:
+    PolledAttachment(Group& g, juce::AudioProcessorValueTreeState& state, const juce::String& parameterID)
+        : group(g), parameter(*state.getParameter(parameterID))
+    {
+        group.attachments.push_back(this);
+    }
+
+    void setParameter(float value)
+    {
+        if (updatingControl)
+            return;
+
+        lastValue = value; // The control already shows it
+        if (!inGesture)
+            parameter.beginChangeGesture();
+
+        parameter.setValueNotifyingHost(parameter.convertTo0to1(value));
+
+        if (!inGesture)
+            parameter.endChangeGesture();
+    }
+
+    void sliderValueChanged(juce::Slider* s) override { setParameter(static_cast<float>(s->getValue())); }
+    void sliderDragStarted(juce::Slider*) override { inGesture = true; parameter.beginChangeGesture(); }
+    void sliderDragEnded(juce::Slider*) override { parameter.endChangeGesture(); inGesture = false; }
+    void buttonClicked(juce::Button* b) override { setParameter(b->getToggleState() ? 1.0f : 0.0f); }
+    void comboBoxChanged(juce::ComboBox* c) override { setParameter(static_cast<float>(c->getSelectedItemIndex())); }
+
+    Group& group;
+    juce::RangedAudioParameter& parameter;
+    juce::Slider* slider = nullptr;
+    juce::Button* button = nullptr;
+    juce::ComboBox* comboBox = nullptr;
+    float lastValue = std::numeric_limits<float>::quiet_NaN(); // Forces the first refresh through
+    bool updatingControl = false, inGesture = false;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(PolledAttachment)
+};
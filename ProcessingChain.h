@@ -0,0 +1,78 @@
+#pragma once
+#include <JuceHeader.h>
+#include <array>
+#include "CoefficientBank.h"
+#include "MultichannelCascade.h"
+#include "BandCut.h"
+#include "Saturator.h"
+
+// The minimum-phase signal path for one processing precision: the four bands, the cuts of muted bands
+// and the saturator. The processor keeps one per precision and feeds both the same sections.
+template <typename SampleType, template <typename> class Topology>
+struct ProcessingChain
+{
+    MultichannelCascade<SampleType, CoefficientBank::numBands, Topology> eqCascade; // One stage per band, one SIMD lane per channel
+    std::array<BandCut<SampleType, Topology>, CoefficientBank::numBands> bandCuts; // Only processed while a band is muted
+    Saturator<SampleType> saturator; // Per instance, so the drive of one instance can't leak into another
+
+    void prepare(const juce::dsp::ProcessSpec& spec)
+    {
+        saturator.prepare(spec);
+        saturator.reset();
+
+        eqCascade.prepare(spec.sampleRate, spec.numChannels);
+        eqCascade.reset();
+
+        for (auto& cut : bandCuts)
+            cut.prepare(spec.sampleRate, spec.numChannels);
+    }
+
+    void resetFilters() noexcept
+    {
+        eqCascade.reset();
+        for (auto& cut : bandCuts)
+            cut.reset();
+    }
+
+    void snapFiltersToTargets() noexcept
+    {
+        eqCascade.snapToTargets();
+        for (auto& cut : bandCuts)
+            cut.snapToTarget();
+    }
+
+    // A muted band sits flat in the main cascade and is cut by its own stage instead
+    void setBand(int band, const BiquadCoefficients& section, const BiquadCoefficients* cut) noexcept
+    {
+        eqCascade.setTargetCoefficients(static_cast<size_t>(band), section);
+
+        auto& bandCut = bandCuts[static_cast<size_t>(band)];
+        if (cut != nullptr)
+            bandCut.engage(*cut);
+        else
+            bandCut.release();
+    }
+
+    // One channel only, for the stereo modes that give the second channel its own band set
+    void setBand(int band, size_t channel, const BiquadCoefficients& section, const BiquadCoefficients* cut) noexcept
+    {
+        eqCascade.setTargetCoefficients(static_cast<size_t>(band), channel, section);
+        bandCuts[static_cast<size_t>(band)].setChannel(channel, cut);
+    }
+
+    // Mid/side is encoded on the way into the band cascade and decoded on the way out of the saturator
+    void setStereoMode(StereoMode mode) noexcept
+    {
+        eqCascade.setMidSideEncoding(mode == StereoMode::midSide);
+        saturator.setStereoMode(mode);
+    }
+
+    // All four bands for a whole SIMD group of channels per pass over the buffer; flat bands are skipped inside
+    void processFilters(SampleType* const* channels, size_t numChannels, size_t numSamples) noexcept
+    {
+        eqCascade.process(channels, numChannels, numSamples);
+
+        for (auto& cut : bandCuts)
+            cut.process(channels, numChannels, numSamples);
+    }
+};
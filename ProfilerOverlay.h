@@ -0,0 +1,54 @@
+#pragma once
+#include <JuceHeader.h>
+#include "StageProfiler.h"
+
+#if EQALPHA_PROFILING
+
+// Text overlay of the profiler's latest summaries, drawn over the analyser. Only exists in profiling builds.
+class ProfilerOverlay : public juce::Component, private juce::Timer
+{
+public:
+    explicit ProfilerOverlay(const StageProfiler& p) : profiler(p)
+    {
+        setInterceptsMouseClicks(false, false);
+        startTimerHz(4);
+    }
+
+    void paint(juce::Graphics& g) override
+    {
+        g.setColour(juce::Colours::black.withAlpha(0.6f));
+        g.fillRoundedRectangle(getLocalBounds().toFloat(), 4.0f);
+
+        g.setColour(stats.numOverruns > 0 ? juce::Colours::orange : juce::Colours::lightgrey);
+        g.setFont(juce::FontOptions(juce::Font::getDefaultMonospacedFontName(), 11.0f, juce::Font::plain));
+
+        auto area = getLocalBounds().reduced(6, 4);
+        auto drawLine = [&](const juce::String& text) { g.drawText(text, area.removeFromTop(13), juce::Justification::left, false); };
+
+        drawLine(juce::String::formatted("%-10s %7s %7s %7s %7s", "us/block", "min", "avg", "p99", "max"));
+
+        for (int stage = 0; stage <= StageProfiler::numStages; ++stage)
+        {
+            const auto& s = stage < StageProfiler::numStages ? stats.stages[static_cast<size_t>(stage)] : stats.total;
+            drawLine(juce::String::formatted("%-10s %7.1f %7.1f %7.1f %7.1f", juce::String(StageProfiler::getStageName(stage)).toRawUTF8(),
+                s.min, s.average, s.p99, s.max));
+        }
+
+        drawLine(juce::String::formatted("overruns %lld, worst %.1f%% of deadline", static_cast<long long>(stats.numOverruns),
+            100.0 * stats.worstDeadlineFraction));
+    }
+
+private:
+    void timerCallback() override
+    {
+        stats = profiler.getStats();
+        repaint();
+    }
+
+    const StageProfiler& profiler;
+    StageProfiler::Stats stats;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(ProfilerOverlay)
+};
+
+#endif
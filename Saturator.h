@@ -0,0 +1,159 @@
+#pragma once
+#include <JuceHeader.h>
+#include <array>
+#include <memory>
+#include "StereoMode.h"
+
+// tanh saturation with a per-instance, smoothed drive and optional 2x/4x/8x oversampling.
+// The drive is stepped once per sub-block, so a moving drive knob costs no more than a static one.
+template <typename SampleType>
+class Saturator
+{
+public:
+    static constexpr size_t subBlockSize = 32;
+    static constexpr int maxOversamplingIndex = 3; // 0 = 1x, 1 = 2x, 2 = 4x, 3 = 8x
+
+    // Allocates the oversampling stages up front, so switching factors later is free
+    void prepare(const juce::dsp::ProcessSpec& spec)
+    {
+        drive.reset(spec.sampleRate / static_cast<double>(subBlockSize), 0.05);
+        secondDrive.reset(spec.sampleRate / static_cast<double>(subBlockSize), 0.05);
+
+        for (int i = 1; i <= maxOversamplingIndex; ++i)
+        {
+            auto& os = oversamplers[static_cast<size_t>(i - 1)];
+            os = std::make_unique<juce::dsp::Oversampling<SampleType>>(spec.numChannels, static_cast<size_t>(i),
+                juce::dsp::Oversampling<SampleType>::filterHalfBandPolyphaseIIR, true, true);
+            os->initProcessing(static_cast<size_t>(spec.maximumBlockSize));
+        }
+    }
+
+    void reset() noexcept
+    {
+        for (auto& os : oversamplers)
+            if (os != nullptr)
+                os->reset();
+    }
+
+    void setDrive(SampleType newDrive) noexcept { drive.setTargetValue(newDrive); }
+
+    // Drive of the right or side channel, used unless the stereo mode is linked
+    void setSecondDrive(SampleType newDrive) noexcept { secondDrive.setTargetValue(newDrive); }
+
+    // In mid/side mode the first two channels arrive encoded and leave as left/right. Decoding happens
+    // sub-block by sub-block right after saturating, before downsampling (the downsampler is linear).
+    void setStereoMode(StereoMode newMode) noexcept { stereoMode = newMode; }
+
+    void snapToTarget() noexcept
+    {
+        drive.setCurrentAndTargetValue(drive.getTargetValue());
+        secondDrive.setCurrentAndTargetValue(secondDrive.getTargetValue());
+    }
+
+    void setOversamplingIndex(int newIndex) noexcept
+    {
+        newIndex = juce::jlimit(0, maxOversamplingIndex, newIndex);
+
+        if (newIndex != oversamplingIndex && newIndex > 0 && oversamplers[static_cast<size_t>(newIndex - 1)] != nullptr)
+            oversamplers[static_cast<size_t>(newIndex - 1)]->reset();
+
+        oversamplingIndex = newIndex;
+    }
+
+    // Rounded to whole samples, since that's all a host can compensate
+    int getLatencyInSamples() const noexcept
+    {
+        auto* os = getActiveOversampler();
+        return os != nullptr ? juce::roundToInt(os->getLatencyInSamples()) : 0;
+    }
+
+    void process(SampleType* const* channels, size_t numChannels, size_t numSamples) noexcept
+    {
+        auto* os = getActiveOversampler();
+
+        if (os == nullptr)
+        {
+            processSubBlocks(channels, numChannels, numSamples, 1);
+            return;
+        }
+
+        juce::dsp::AudioBlock<SampleType> block(channels, numChannels, numSamples);
+        auto upsampled = os->processSamplesUp(block);
+
+        // The oversampled block keeps its own channel pointers
+        std::array<SampleType*, maxChannels> upChannels{};
+        const auto numUpChannels = juce::jmin(numChannels, maxChannels);
+        for (size_t ch = 0; ch < numUpChannels; ++ch)
+            upChannels[ch] = upsampled.getChannelPointer(ch);
+
+        processSubBlocks(upChannels.data(), numUpChannels, upsampled.getNumSamples(), os->getOversamplingFactor());
+        os->processSamplesDown(block);
+    }
+
+private:
+    static constexpr size_t maxChannels = 16;
+
+    juce::dsp::Oversampling<SampleType>* getActiveOversampler() const noexcept
+    {
+        return oversamplingIndex > 0 ? oversamplers[static_cast<size_t>(oversamplingIndex - 1)].get() : nullptr;
+    }
+
+    // One drive step per sub-block of the original rate, however many samples that is after oversampling
+    void processSubBlocks(SampleType* const* channels, size_t numChannels, size_t numSamples, size_t factor) noexcept
+    {
+        const auto step = subBlockSize * factor;
+
+        const auto separateSecond = stereoMode != StereoMode::linked && numChannels == 2;
+
+        for (size_t start = 0; start < numSamples; start += step)
+        {
+            const auto num = juce::jmin(step, numSamples - start);
+            const auto currentDrive = drive.getNextValue();
+            const auto currentSecondDrive = secondDrive.getNextValue();
+
+            for (size_t ch = 0; ch < numChannels; ++ch)
+            {
+                const auto channelDrive = separateSecond && ch == 1 ? currentSecondDrive : currentDrive;
+
+                // Avoid division by zero by leaving the signal alone when the drive is (close to) 0
+                if (channelDrive > SampleType(0.001))
+                    saturate(channels[ch] + start, num, channelDrive);
+            }
+
+            if (separateSecond && stereoMode == StereoMode::midSide)
+                decodeMidSide(channels[0] + start, channels[1] + start, num);
+        }
+    }
+
+    static void decodeMidSide(SampleType* __restrict mid, SampleType* __restrict side, size_t num) noexcept
+    {
+        for (size_t i = 0; i < num; ++i)
+        {
+            const auto m = mid[i], s = side[i];
+            mid[i] = m + s;
+            side[i] = m - s;
+        }
+    }
+
+    // Rational (Pade 7/6) approximation of tanh(drive * x) / drive, within 1e-4 of std::tanh.
+    // Branch-free and call-free, so the compiler turns the loop into packed SIMD.
+    static void saturate(SampleType* __restrict data, size_t num, SampleType currentDrive) noexcept
+    {
+        constexpr auto limit = SampleType(4.97); // The approximation reaches 1 here
+        const auto invDrive = SampleType(1) / currentDrive;
+
+        for (size_t i = 0; i < num; ++i)
+        {
+            const auto x = juce::jmin(limit, juce::jmax(-limit, currentDrive * data[i]));
+            const auto x2 = x * x;
+            const auto numerator = x * (SampleType(135135) + x2 * (SampleType(17325) + x2 * (SampleType(378) + x2)));
+            const auto denominator = SampleType(135135) + x2 * (SampleType(62370) + x2 * (SampleType(3150) + x2 * SampleType(28)));
+            data[i] = numerator / denominator * invDrive;
+        }
+    }
+
+    juce::SmoothedValue<SampleType> drive{ SampleType(2) }, secondDrive{ SampleType(2) };
+    StereoMode stereoMode = StereoMode::linked;
+    std::array<std::unique_ptr<juce::dsp::Oversampling<SampleType>>, maxOversamplingIndex> oversamplers;
+    int oversamplingIndex = 0;
+};
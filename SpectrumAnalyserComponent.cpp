@@ -0,0 +1,181 @@
+#include "SpectrumAnalyserComponent.h"
+
+SpectrumAnalyserComponent::SpectrumAnalyserComponent(Api550bAudioProcessor& p)
+    : audioProcessor(p), preSpectrum(p.getPreAnalyserFifo()), postSpectrum(p.getPostAnalyserFifo())
+{
+    for (int i = 0; i < numPoints; ++i)
+        pointFrequencies[static_cast<size_t>(i)] = minFrequency * std::pow(maxFrequency / minFrequency, static_cast<float>(i) / (numPoints - 1));
+
+    preSpectrum.levelsDb.fill(spectrumFloorDb);
+    postSpectrum.levelsDb.fill(spectrumFloorDb);
+
+    setInterceptsMouseClicks(false, false);
+
+    audioProcessor.setAnalyserActive(true);
+    startTimerHz(60);
+}
+
+SpectrumAnalyserComponent::~SpectrumAnalyserComponent()
+{
+    stopTimer();
+    audioProcessor.setAnalyserActive(false);
+}
+
+void SpectrumAnalyserComponent::timerCallback()
+{
+    const auto preChanged = updateSpectrum(preSpectrum);
+    const auto postChanged = updateSpectrum(postSpectrum);
+    const auto curveChanged = updateResponseCurve();
+
+    if (preChanged || postChanged || curveChanged)
+        repaint();
+}
+
+bool SpectrumAnalyserComponent::updateSpectrum(Spectrum& s)
+{
+    const auto numPulled = s.fifo.pull(pullBuffer.data(), static_cast<int>(pullBuffer.size()));
+    const auto sampleRate = audioProcessor.getSampleRate();
+
+    if (numPulled == 0 || sampleRate <= 0.0)
+        return false;
+
+    // Keep the most recent fftSize samples
+    auto& history = s.history;
+    if (numPulled >= fftSize)
+    {
+        std::copy_n(pullBuffer.data() + numPulled - fftSize, fftSize, history.data());
+    }
+    else
+    {
+        std::move(history.begin() + numPulled, history.end(), history.begin());
+        std::copy_n(pullBuffer.data(), numPulled, history.end() - numPulled);
+    }
+
+    std::copy(history.begin(), history.end(), fftData.begin());
+    std::fill(fftData.begin() + fftSize, fftData.end(), 0.0f);
+    window.multiplyWithWindowingTable(fftData.data(), static_cast<size_t>(fftSize));
+    fft.performFrequencyOnlyForwardTransform(fftData.data());
+
+    // A full-scale sine reads 0 dB (the window is normalised, so only the one-sided 2/N remains)
+    const auto scale = 2.0f / static_cast<float>(fftSize);
+    const auto binsPerHz = static_cast<float>(fftSize / sampleRate);
+
+    for (size_t i = 0; i < static_cast<size_t>(numPoints); ++i)
+    {
+        const auto bin = juce::jlimit(0.0f, static_cast<float>(fftSize / 2 - 1), pointFrequencies[i] * binsPerHz);
+        const auto index = static_cast<int>(bin);
+        const auto frac = bin - static_cast<float>(index);
+        const auto magnitude = fftData[static_cast<size_t>(index)] * (1.0f - frac) + fftData[static_cast<size_t>(index + 1)] * frac;
+        const auto db = juce::Decibels::gainToDecibels(magnitude * scale, spectrumFloorDb);
+
+        // Fast attack, ~90 dB/s release at 60 fps
+        s.levelsDb[i] = juce::jmax(db, s.levelsDb[i] - 1.5f);
+    }
+
+    return true;
+}
+
+bool SpectrumAnalyserComponent::updateResponseCurve()
+{
+    const auto sampleRate = audioProcessor.getSampleRate();
+    if (sampleRate <= 0.0)
+        return false;
+
+    const auto rateChanged = bank.getSampleRate() != sampleRate;
+    bank.prepare(sampleRate);
+
+    const auto& pointers = audioProcessor.getParameterPointers();
+    ParameterSnapshot current;
+    current.readGlobals(pointers);
+
+    auto anyChanged = false;
+
+    for (int band = 0; band < CoefficientBank::numBands; ++band)
+    {
+        const auto b = static_cast<size_t>(band);
+        current.readBand(pointers, band);
+
+        if (responseValid && !rateChanged && current.proportionalQ == cachedSnapshot.proportionalQ
+            && current.cutLevelIndex == cachedSnapshot.cutLevelIndex && current.bands[b] == cachedSnapshot.bands[b]
+            && current.continuous == cachedSnapshot.continuous && current.continuousBands[b] == cachedSnapshot.continuousBands[b])
+            continue;
+
+        // Continuous mode is designed exactly here; the audio thread's table is within a fraction of a dB of it
+        const auto& settings = current.bands[b];
+        const auto& values = current.continuousBands[b];
+        const auto section = current.continuous ? bank.design(band, settings, values, current.proportionalQ)
+                                                : bank.get(band, settings, current.proportionalQ);
+        const auto muted = settings.mute && !settings.bypass;
+        const auto cut = current.continuous ? bank.designCut(band, values.freqHz, current.cutLevelIndex)
+                                            : bank.getCut(band, settings.freqIndex, current.cutLevelIndex);
+
+        for (size_t i = 0; i < static_cast<size_t>(numPoints); ++i)
+        {
+            auto magnitude = section.getMagnitudeForFrequency(pointFrequencies[i], sampleRate);
+            if (muted)
+                magnitude *= std::pow(cut.getMagnitudeForFrequency(pointFrequencies[i], sampleRate), static_cast<double>(CoefficientBank::numCutSections));
+
+            bandResponseDb[b][i] = juce::Decibels::gainToDecibels(static_cast<float>(magnitude));
+        }
+
+        anyChanged = true;
+    }
+
+    cachedSnapshot = current;
+    responseValid = true;
+
+    if (anyChanged)
+    {
+        curveDb.fill(0.0f);
+        for (auto& response : bandResponseDb)
+            for (size_t i = 0; i < static_cast<size_t>(numPoints); ++i)
+                curveDb[i] += response[i];
+    }
+
+    return anyChanged;
+}
+
+juce::Path SpectrumAnalyserComponent::createPath(const std::array<float, numPoints>& values, float minDb, float maxDb) const
+{
+    const auto bounds = getLocalBounds().toFloat().reduced(4.0f);
+    juce::Path path;
+
+    for (int i = 0; i < numPoints; ++i)
+    {
+        const auto x = bounds.getX() + bounds.getWidth() * static_cast<float>(i) / (numPoints - 1);
+        const auto y = juce::jmap(juce::jlimit(minDb, maxDb, values[static_cast<size_t>(i)]), minDb, maxDb, bounds.getBottom(), bounds.getY());
+
+        if (i == 0)
+            path.startNewSubPath(x, y);
+        else
+            path.lineTo(x, y);
+    }
+
+    return path;
+}
+
+void SpectrumAnalyserComponent::paint(juce::Graphics& g)
+{
+    auto bounds = getLocalBounds().toFloat();
+    g.setColour(juce::Colour(0xff1a1a1a));
+    g.fillRoundedRectangle(bounds, 10.0f);
+
+    // Decade lines and the 0 dB line of the EQ curve
+    const auto inner = bounds.reduced(4.0f);
+    g.setColour(juce::Colours::white.withAlpha(0.08f));
+    for (auto freq : { 100.0f, 1000.0f, 10000.0f })
+    {
+        const auto x = inner.getX() + inner.getWidth() * std::log(freq / minFrequency) / std::log(maxFrequency / minFrequency);
+        g.drawVerticalLine(juce::roundToInt(x), inner.getY(), inner.getBottom());
+    }
+    g.drawHorizontalLine(juce::roundToInt(inner.getCentreY()), inner.getX(), inner.getRight());
+
+    g.setColour(juce::Colours::lightgrey.withAlpha(0.3f));
+    g.strokePath(createPath(preSpectrum.levelsDb, spectrumFloorDb, 0.0f), juce::PathStrokeType(1.0f));
+
+    g.setColour(juce::Colours::whitesmoke.withAlpha(0.7f));
+    g.strokePath(createPath(postSpectrum.levelsDb, spectrumFloorDb, 0.0f), juce::PathStrokeType(1.0f));
+
+    g.setColour(juce::Colour(0xffffa500));
+    g.strokePath(createPath(curveDb, -curveRangeDb, curveRangeDb), juce::PathStrokeType(2.0f));
+}
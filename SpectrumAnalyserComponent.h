@@ -0,0 +1,55 @@
+#pragma once
+#include <JuceHeader.h>
+#include "PluginProcessor.h"
+
+// Pre/post spectrum plus the composite response of the four bands.
+// Everything runs on the message thread from a timer; the audio thread only fills the FIFOs.
+class SpectrumAnalyserComponent : public juce::Component, private juce::Timer
+{
+public:
+    explicit SpectrumAnalyserComponent(Api550bAudioProcessor&);
+    ~SpectrumAnalyserComponent() override;
+
+    void paint(juce::Graphics&) override;
+
+private:
+    static constexpr int fftOrder = 11;
+    static constexpr int fftSize = 1 << fftOrder;
+    static constexpr int numPoints = 256; // Log-spaced display points, 20 Hz .. 20 kHz
+    static constexpr float minFrequency = 20.0f, maxFrequency = 20000.0f;
+    static constexpr float spectrumFloorDb = -90.0f;
+    static constexpr float curveRangeDb = 15.0f;
+
+    struct Spectrum
+    {
+        explicit Spectrum(AnalyserFifo& f) : fifo(f) {}
+
+        AnalyserFifo& fifo;
+        std::array<float, fftSize> history{};
+        std::array<float, numPoints> levelsDb{};
+    };
+
+    void timerCallback() override;
+    bool updateSpectrum(Spectrum&);
+    bool updateResponseCurve();
+
+    juce::Path createPath(const std::array<float, numPoints>& values, float minDb, float maxDb) const;
+
+    Api550bAudioProcessor& audioProcessor;
+    std::array<float, numPoints> pointFrequencies{};
+
+    juce::dsp::FFT fft{ fftOrder };
+    juce::dsp::WindowingFunction<float> window{ static_cast<size_t>(fftSize), juce::dsp::WindowingFunction<float>::hann };
+    std::array<float, 2 * fftSize> fftData{};
+    std::array<float, AnalyserFifo::capacity> pullBuffer{};
+    Spectrum preSpectrum, postSpectrum;
+
+    // One cached response per band; a band is only re-evaluated when its settings change
+    CoefficientBank bank;
+    ParameterSnapshot cachedSnapshot;
+    std::array<std::array<float, numPoints>, CoefficientBank::numBands> bandResponseDb{};
+    std::array<float, numPoints> curveDb{};
+    bool responseValid = false;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(SpectrumAnalyserComponent)
+};
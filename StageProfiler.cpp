@@ -0,0 +1,155 @@
+#include "StageProfiler.h"
+
+#if EQALPHA_PROFILING
+
+#include <algorithm>
+
+juce::StringRef StageProfiler::getStageName(int stage) noexcept
+{
+    switch (stage)
+    {
+        case parameters: return "parameters";
+        case filters:    return "filters";
+        case saturation: return "saturation";
+        case autoGain:   return "auto gain";
+        case analyser:   return "analyser";
+        default:         return "total";
+    }
+}
+
+StageProfiler::StageProfiler()
+    : juce::Thread("EQ profiler")
+{
+    const auto logPath = juce::SystemStats::getEnvironmentVariable("EQALPHA_PROFILE_LOG", {});
+    if (logPath.isNotEmpty())
+        logFile = juce::File::getCurrentWorkingDirectory().getChildFile(logPath);
+
+    window.reserve(static_cast<size_t>(windowSize));
+}
+
+StageProfiler::~StageProfiler()
+{
+    stopThread(1000);
+}
+
+void StageProfiler::prepare(double sampleRate)
+{
+    {
+        const juce::ScopedLock sl(statsLock);
+        currentSampleRate.store(sampleRate, std::memory_order_relaxed);
+        window.clear();
+        windowPosition = 0;
+        stats = {};
+        fifo.reset(); // The stream isn't running, so nothing is pushing
+    }
+
+    if (!isThreadRunning())
+        startThread();
+}
+
+StageProfiler::Stats StageProfiler::getStats() const
+{
+    const juce::ScopedLock sl(statsLock);
+    return stats;
+}
+
+void StageProfiler::push(const Record& record) noexcept
+{
+    // A full ring means the aggregation thread is behind; that block just isn't counted
+    int start1, size1, start2, size2;
+    fifo.prepareToWrite(1, start1, size1, start2, size2);
+
+    if (size1 > 0)
+        ring[static_cast<size_t>(start1)] = record;
+
+    fifo.finishedWrite(size1);
+}
+
+void StageProfiler::run()
+{
+    while (!threadShouldExit())
+    {
+        aggregate();
+        wait(reportIntervalMs);
+    }
+}
+
+void StageProfiler::aggregate()
+{
+    const juce::ScopedLock sl(statsLock);
+
+    const auto ticksToMicroseconds = 1.0e6 / static_cast<double>(juce::Time::getHighResolutionTicksPerSecond());
+    const auto sampleRate = currentSampleRate.load(std::memory_order_relaxed);
+    const auto fraction = deadlineFraction.load(std::memory_order_relaxed);
+
+    int start1, size1, start2, size2;
+    fifo.prepareToRead(fifo.getNumReady(), start1, size1, start2, size2);
+    const auto numNew = size1 + size2;
+
+    for (int i = 0; i < numNew; ++i)
+    {
+        const auto& record = ring[static_cast<size_t>(i < size1 ? start1 + i : start2 + i - size1)];
+
+        if (sampleRate > 0.0 && record.numSamples > 0)
+        {
+            const auto deadlineMicroseconds = 1.0e6 * record.numSamples / sampleRate;
+            const auto usedFraction = record.totalTicks * ticksToMicroseconds / deadlineMicroseconds;
+            stats.worstDeadlineFraction = juce::jmax(stats.worstDeadlineFraction, usedFraction);
+
+            if (usedFraction > fraction)
+                ++stats.numOverruns;
+        }
+
+        if (window.size() < static_cast<size_t>(windowSize))
+            window.push_back(record);
+        else
+            window[windowPosition] = record;
+
+        windowPosition = (windowPosition + 1) % static_cast<size_t>(windowSize);
+    }
+
+    fifo.finishedRead(numNew);
+
+    if (numNew == 0 || window.empty())
+        return;
+
+    std::vector<double> values(window.size());
+
+    auto summarise = [&](auto ticksOf) {
+        std::transform(window.begin(), window.end(), values.begin(), [&](const Record& r) { return ticksOf(r) * ticksToMicroseconds; });
+        std::sort(values.begin(), values.end());
+
+        Summary s;
+        s.min = values.front();
+        s.max = values.back();
+        s.p99 = values[static_cast<size_t>(0.99 * static_cast<double>(values.size() - 1))];
+        for (auto v : values)
+            s.average += v;
+        s.average /= static_cast<double>(values.size());
+        return s;
+        };
+
+    for (size_t stage = 0; stage < numStages; ++stage)
+        stats.stages[stage] = summarise([stage](const Record& r) { return static_cast<double>(r.stageTicks[stage]); });
+
+    stats.total = summarise([](const Record& r) { return static_cast<double>(r.totalTicks); });
+    stats.numBlocks = static_cast<int>(window.size());
+
+    if (logFile != juce::File())
+    {
+        juce::String line;
+        line << juce::Time::getCurrentTime().toISO8601(true) << " blocks " << stats.numBlocks << " overruns " << stats.numOverruns
+             << " worst " << juce::String(100.0 * stats.worstDeadlineFraction, 1) << "%";
+
+        for (int stage = 0; stage <= numStages; ++stage)
+        {
+            const auto& s = stage < numStages ? stats.stages[static_cast<size_t>(stage)] : stats.total;
+            line << " | " << getStageName(stage) << " min/avg/p99/max us " << juce::String(s.min, 1) << "/" << juce::String(s.average, 1)
+                 << "/" << juce::String(s.p99, 1) << "/" << juce::String(s.max, 1);
+        }
+
+        logFile.appendText(line + "\n");
+    }
+}
+
+#endif
@@ -0,0 +1,118 @@
+#pragma once
+#include <JuceHeader.h>
+#include <array>
+#include <vector>
+
+// Per-stage timing of processBlock. Define EQALPHA_PROFILING=1 in the build to compile it in; otherwise the
+// EQALPHA_PROFILE_* macros expand to nothing and none of this exists in the binary.
+#ifndef EQALPHA_PROFILING
+ #define EQALPHA_PROFILING 0
+#endif
+
+#if EQALPHA_PROFILING
+
+// The audio thread takes high-resolution tick stamps between the stages of a block and pushes one record
+// per block into a wait-free ring. A background thread drains it into min/avg/p99/max per stage over the
+// last few seconds, and counts blocks that used more than a set fraction of their real-time deadline.
+// If EQALPHA_PROFILE_LOG names a file, every report is also appended to it.
+class StageProfiler : private juce::Thread
+{
+public:
+    enum Stage { parameters, filters, saturation, autoGain, analyser, numStages };
+    static juce::StringRef getStageName(int stage) noexcept;
+
+    struct Record
+    {
+        std::array<juce::int64, numStages> stageTicks{};
+        juce::int64 totalTicks = 0;
+        int numSamples = 0;
+    };
+
+    // Times one block on the audio thread; each endStage adds the ticks since the previous mark to that stage
+    class BlockScope
+    {
+    public:
+        BlockScope(StageProfiler& p, int numSamples) noexcept
+            : profiler(p), start(juce::Time::getHighResolutionTicks()), lastMark(start)
+        {
+            record.numSamples = numSamples;
+        }
+
+        ~BlockScope()
+        {
+            record.totalTicks = juce::Time::getHighResolutionTicks() - start;
+            profiler.push(record);
+        }
+
+        void endStage(Stage stage) noexcept
+        {
+            const auto now = juce::Time::getHighResolutionTicks();
+            record.stageTicks[static_cast<size_t>(stage)] += now - lastMark;
+            lastMark = now;
+        }
+
+    private:
+        StageProfiler& profiler;
+        Record record;
+        juce::int64 start, lastMark;
+
+        JUCE_DECLARE_NON_COPYABLE(BlockScope)
+    };
+
+    // Microseconds per block; "total" covers the whole processBlock, not just the sum of the stages
+    struct Summary
+    {
+        double min = 0.0, average = 0.0, p99 = 0.0, max = 0.0;
+    };
+
+    struct Stats
+    {
+        std::array<Summary, numStages> stages;
+        Summary total;
+        double worstDeadlineFraction = 0.0;
+        int numBlocks = 0;          // In the window the summaries cover
+        juce::int64 numOverruns = 0; // Since prepare
+    };
+
+    StageProfiler();
+    ~StageProfiler() override;
+
+    // Clears the history and starts the aggregation thread; not realtime safe
+    void prepare(double sampleRate);
+
+    // Blocks taking longer than this fraction of their duration count as overruns
+    void setDeadlineFraction(double fraction) noexcept { deadlineFraction.store(fraction, std::memory_order_relaxed); }
+
+    Stats getStats() const;
+
+private:
+    static constexpr int ringSize = 1 << 12;
+    static constexpr int windowSize = 1 << 13; // Blocks kept for the summaries
+    static constexpr int reportIntervalMs = 250;
+
+    void push(const Record& record) noexcept;
+    void run() override;
+    void aggregate();
+
+    juce::AbstractFifo fifo{ ringSize };
+    std::array<Record, ringSize> ring;
+
+    std::atomic<double> deadlineFraction{ 0.5 };
+    std::atomic<double> currentSampleRate{ 0.0 };
+
+    // Everything below is guarded by statsLock
+    juce::CriticalSection statsLock;
+    std::vector<Record> window;
+    size_t windowPosition = 0;
+    juce::File logFile;
+    Stats stats;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(StageProfiler)
+};
+
+ #define EQALPHA_PROFILE_BLOCK(profiler, numSamples) StageProfiler::BlockScope eqAlphaProfileScope(profiler, static_cast<int>(numSamples))
+ #define EQALPHA_PROFILE_STAGE(stage) eqAlphaProfileScope.endStage(StageProfiler::stage)
+#else
+ #define EQALPHA_PROFILE_BLOCK(profiler, numSamples)
+ #define EQALPHA_PROFILE_STAGE(stage)
+#endif
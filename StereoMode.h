@@ -0,0 +1,10 @@
+#pragma once
+
+// How the two channels of a stereo bus are processed. The second band set and drive are used in the
+// dual-mono and mid/side modes, for the right and the side channel respectively.
+enum class StereoMode
+{
+    linked,   // Both channels get the first band set and drive
+    dualMono, // Left gets the first set, right the second
+    midSide   // Encoded on the way into the filters, decoded on the way out of the saturator
+};